@@ -137,6 +137,9 @@ struct HttpWebSocket;
 #ifndef ME_HTTP_DELAY
     #define ME_HTTP_DELAY           (2000)               /**< 2 second delay per request - while delay enforced */
 #endif
+#ifndef ME_HTTP_COMPRESS_MIN
+    #define ME_HTTP_COMPRESS_MIN    256                  /**< Minimum response size to compress */
+#endif
 #ifndef ME_DIGEST_NONCE_DURATION
     #define ME_DIGEST_NONCE_DURATION 60                  /**< Lifespan for Digest auth request nonce */
 #endif
@@ -146,6 +149,9 @@ struct HttpWebSocket;
 #ifndef ME_MAX_IOVEC
     #define ME_MAX_IOVEC            16                   /**< Number of fragments in a single socket write */
 #endif
+#ifndef ME_STATIC_PACKET_MIN
+    #define ME_STATIC_PACKET_MIN    256                  /**< Minimum HTTP_STATIC write to reference rather than copy */
+#endif
 #ifndef ME_MAX_CLIENTS_HASH
     #define ME_MAX_CLIENTS_HASH     131                  /**< Hash table for client IP addresses */
 #endif
@@ -242,6 +248,9 @@ struct HttpWebSocket;
 #ifndef ME_MAX_WSS_MESSAGE
     #define ME_MAX_WSS_MESSAGE      (2147483647)         /**< Default max WebSockets message size (2GB) */
 #endif
+#ifndef ME_MAX_WSS_WINDOW
+    #define ME_MAX_WSS_WINDOW       15                   /**< Default max WebSockets deflate window size in bits */
+#endif
 #ifndef ME_MAX_CACHE_DURATION
     #define ME_MAX_CACHE_DURATION   (86400 * 1000)       /**< Default cache lifespan to 1 day */
 #endif
@@ -1041,6 +1050,7 @@ typedef struct Http {
     struct HttpStage *cacheFilter;          /**< Cache filter */
     struct HttpStage *cacheHandler;         /**< Cache filter */
     struct HttpStage *chunkFilter;          /**< Chunked transfer encoding filter */
+    struct HttpStage *compressFilter;       /**< Dynamic response compression filter */
     struct HttpStage *httpFilter;           /**< Http filter */
     struct HttpStage *cgiHandler;           /**< CGI handler */
     struct HttpStage *cgiConnector;         /**< CGI connector */
@@ -1521,6 +1531,8 @@ typedef struct HttpLimits {
     int      webSocketsMessageSize;     /**< Maximum total size of a WebSocket message including all frames */
     int      webSocketsPacketSize;      /**< Maximum size of a WebSocket packet exchanged with the user callback */
     MprTicks webSocketsPing;            /**< Time between pings */
+    int      webSocketsWindow;          /**< Maximum permessage-deflate window size in bits (9-15). Bounds the
+                                             compression memory used per WebSocket. */
 #endif
 #if ME_HTTP_HTTP2 || DOXYGEN
     int      frameSize;                 /**< HTTP/2 maximum frame size */
@@ -2033,6 +2045,20 @@ PUBLIC HttpPacket *httpCreateEndPacket(void);
  */
 PUBLIC HttpPacket *httpCreateEntityPacket(MprOff pos, MprOff size, HttpFillProc fill);
 
+/**
+    Create a data packet that references static data
+    @description Create a data packet whose content references the given data without copying.
+        The data must be static, read-only memory that outlives the packet, such as a string constant.
+        If the data is owned by a managed object, set HttpPacket.data to the owner to retain it while the packet
+        is in use.
+    @param data Static data
+    @param size Size of the data
+    @return HttpPacket object.
+    @ingroup HttpPacket
+    @stability Prototype
+ */
+PUBLIC HttpPacket *httpCreateStaticPacket(cchar *data, ssize size);
+
 /**
     Create a response header packet
     @description Create a response header packet and set the HTTP_PACKET_HEADER flag.
@@ -2596,6 +2622,7 @@ PUBLIC ssize httpWrite(HttpQueue *q, cchar *fmt, ...) PRINTF_ATTRIBUTE(2,3);
 #define HTTP_BLOCK      0x1    /**< Flag for httpSendBlock and httpWriteBlock to indicate blocking operation */
 #define HTTP_NON_BLOCK  0x2    /**< Flag for httpSendBlock and httpWriteBlock to indicate non-blocking operation */
 #define HTTP_BUFFER     0x4    /**< Flag for httpSendBlock and httpWriteBlock to always absorb the data without blocking */
+#define HTTP_STATIC     0x8    /**< Flag for httpWriteBlock to reference static data rather than copying */
 
 /**
     Write a block of data to the queue
@@ -2625,6 +2652,8 @@ PUBLIC ssize httpWrite(HttpQueue *q, cchar *fmt, ...) PRINTF_ATTRIBUTE(2,3);
     @param flags Set to HTTP_BLOCK for blocking operation or HTTP_NON_BLOCK for non-blocking. Set to HTTP_BUFFER to
         buffer the data if required and never block. Set to zero will default to HTTP_BUFFER.
         This call may yield via mprYield if flags are set to HTTP_BLOCK.
+        Add HTTP_STATIC if the data is static, read-only memory that will outlive the request. Writes of at least
+        ME_STATIC_PACKET_MIN bytes are then queued by reference without copying.
     @return The size value if successful or a negative MPR error code.
     @ingroup HttpQueue
     @stability Evolving
@@ -2644,6 +2673,32 @@ PUBLIC ssize httpWriteBlock(HttpQueue *q, cchar *buf, ssize size, int flags);
  */
 PUBLIC ssize httpWriteString(HttpQueue *q, cchar *s);
 
+/**
+    Write a string of data to the queue with HTML escaping
+    @description Write a string to the queue after escaping HTML special characters. The output is identical to
+        #mprEscapeHtml. A leading run of characters that do not require escaping is copied directly into the queue
+        packets without creating an escaped copy of the string. This call operates in buffering mode (HTTP_BUFFER).
+    @param q Queue reference
+    @param s String containing the data to write
+    @return A count of the bytes actually written or a negative MPR error code.
+    @ingroup HttpQueue
+    @stability Evolving
+ */
+PUBLIC ssize httpWriteSafeString(HttpQueue *q, cchar *s);
+
+/**
+    Write a formatted string to the queue using a va_list
+    @description Format into a stack buffer that is then written to the queue. Output that is too large for the
+        buffer is formatted into a temporary string. This call operates in buffering mode (HTTP_BUFFER).
+    @param q Queue reference
+    @param fmt Printf style formatted string
+    @param args Varargs style list of arguments
+    @return A count of the bytes actually written
+    @ingroup HttpQueue
+    @stability Evolving
+ */
+PUBLIC ssize httpWritev(HttpQueue *q, cchar *fmt, va_list args);
+
 /* Internal */
 
 PUBLIC HttpQueue *httpAppendQueue(HttpQueue *q, HttpQueue *prev);
@@ -3026,6 +3081,7 @@ PUBLIC ssize httpFilterChunkData(HttpQueue *q, HttpPacket *packet);
 PUBLIC int httpOpenActionHandler(void);
 PUBLIC int httpOpenChunkFilter(void);
 PUBLIC int httpOpenCacheHandler(void);
+PUBLIC int httpOpenCompressFilter(void);
 PUBLIC int httpOpenDirHandler(void);
 PUBLIC int httpOpenFileHandler(void);
 PUBLIC int httpOpenPassHandler(void);
@@ -4985,6 +5041,27 @@ typedef struct HttpCache {
     int         flags;                      /**< Cache control flags */
 } HttpCache;
 
+/**
+    Cached response entry
+    @description Server-side cached responses are stored as immutable entries with pre-parsed headers, a precomputed
+        ETag and Last-Modified date and a binary-safe body. Cache hits write the body by reference without copying.
+        If zlib is configured, compressible bodies also store a gzip encoding that is selected via Accept-Encoding.
+    @ingroup HttpCache
+    @stability Internal
+ */
+typedef struct HttpCacheEntry {
+    MprHash     *headers;                   /**< Response headers */
+    cchar       *etag;                      /**< Entity tag */
+    cchar       *lastModified;              /**< Formatted Last-Modified date */
+    char        *body;                      /**< Response body. May contain nulls */
+    ssize       length;                     /**< Length of the body */
+    char        *gzip;                      /**< Gzip encoded body. Null if not compressed */
+    ssize       gzipLength;                 /**< Length of the gzip encoded body */
+    cchar       *gzipEtag;                  /**< Entity tag for the gzip encoded body */
+    MprTime     modified;                   /**< Time the response was cached */
+    int         status;                     /**< Response status */
+} HttpCacheEntry;
+
 /**
     Add caching for response content
     @description This call configures caching for request responses. Caching may be used for any HTTP method,
@@ -5081,6 +5158,36 @@ PUBLIC ssize httpUpdateCache(HttpStream *stream, cchar *uri, cchar *data, MprTic
   */
 PUBLIC ssize httpWriteCached(HttpStream *stream);
 
+/******************************** Compression *********************************/
+/**
+    Dynamic response compression control
+    @description The compression filter compresses response content as it is generated using gzip or deflate
+        content encoding as accepted by the client. Compression is done packet by packet without buffering the
+        response. Only successful responses of the configured mime types that are at least the minimum size are
+        compressed. This requires the zlib component.
+    @defgroup HttpCompress HttpCompress
+    @see HttpCompress httpSetRouteCompress
+    @stability Prototype
+ */
+typedef struct HttpCompress {
+    MprHash     *types;                     /**< Mime types to compress. If null, text, JSON, XML and SVG types */
+    ssize       minSize;                    /**< Minimum response size to compress */
+    int         level;                      /**< Compression level (1-9) */
+} HttpCompress;
+
+/**
+    Enable dynamic compression of responses for a route
+    @param route Route to modify
+    @param level Compression level from 1 (fastest) to 9 (smallest). Set to zero to disable compression.
+    @param minSize Minimum response size to compress. Responses of unknown length are always compressed.
+    @param types Space or comma separated list of mime types to compress. Set to null for the default
+        text, JSON, XML and SVG types.
+    @return Zero if successful, otherwise a negative MPR error code.
+    @ingroup HttpCompress
+    @stability Prototype
+ */
+PUBLIC int httpSetRouteCompress(struct HttpRoute *route, int level, ssize minSize, cchar *types);
+
 /******************************** Action Handler *************************************/
 /**
     Action handler callback signature
@@ -5156,6 +5263,7 @@ PUBLIC void httpSetStreaming(struct HttpHost *host, cchar *mime, cchar *uri, boo
 #define HTTP_ROUTE_LAX_COOKIE           0x200000    /**< Session cookie is SameSite=lax */
 #define HTTP_ROUTE_STRICT_COOKIE        0x400000    /**< Session cookie is SameSite=strict */
 #define HTTP_ROUTE_NONE_COOKIE          0x800000    /**< Session cookie is SameSite=none */
+#define HTTP_ROUTE_WEB_SOCKETS_DEFLATE  0x1000000   /**< Negotiate WebSocket permessage-deflate compression */
 
 /*
     Route hook types
@@ -5226,6 +5334,7 @@ typedef struct HttpRoute {
     bool            json: 1;                /**< Response format is json */
 
     MprList         *caching;               /**< Items to cache */
+    HttpCompress    *compress;              /**< Dynamic compression control */
     MprTicks        lifespan;               /**< Default lifespan for all cache items in route */
     HttpAuth        *auth;                  /**< Per route block authentication */
     Http            *http;                  /**< Http service object (copy of appweb->http) */
@@ -6360,6 +6469,18 @@ PUBLIC void httpSetRoutePrefix(HttpRoute *route, cchar *prefix);
  */
 PUBLIC void httpSetRoutePreserveFrames(HttpRoute *route, bool on);
 
+/**
+    Set the route to compress WebSocket messages
+    @description When enabled, the WebSocketFilter negotiates the permessage-deflate extension (RFC 7692) with
+        the peer. The compression window is bounded by the webSocketsWindow limit. Requires zlib.
+        To enable for client WebSockets, set this on the Http.clientRoute.
+    @param route Route to modify
+    @param on Set to true to negotiate permessage-deflate
+    @ingroup HttpRoute
+    @stability Prototype
+ */
+PUBLIC void httpSetRouteWebSocketsDeflate(HttpRoute *route, bool on);
+
 /**
     Control the renaming of uploaded filenames
     @param route Route to modify
@@ -7017,6 +7138,18 @@ PUBLIC int httpAddBodyParams(HttpStream *stream);
  */
 PUBLIC void httpAddJsonParams(HttpStream *stream);
 
+/**
+    Test if the client accepts a content encoding
+    @description Test the Accept-Encoding request header for the given encoding. An encoding with a quality value
+        of zero is not accepted.
+    @param stream HttpStream stream object
+    @param encoding Content encoding name. For example: "gzip".
+    @return True if the client accepts the encoding.
+    @ingroup HttpRx
+    @stability Prototype
+ */
+PUBLIC bool httpAcceptsEncoding(HttpStream *stream, cchar *encoding);
+
 /**
     Test if the content has not been modified
     @description This call tests if the file content to be served has been modified since the client last
@@ -7506,6 +7639,7 @@ typedef struct HttpTx {
     bool            finalizedConnector:1;   /**< Connector has finished sending the response */
     bool            finalizedInput:1;       /**< Handler has finished processing all input */
     bool            finalizedOutput:1;      /**< Handler or surrogate has finished writing output */
+    bool            flush:1;                /**< Output has been explicitly flushed via #httpFlush or #httpFlushAll */
     bool            needChunking:1;         /**< Use chunk encoding */
     bool            pendingFinalize:1;      /**< Call httpFinalize again once the Tx pipeline is created */
     bool            putEndPacket:1;         /**< Handler has manually put the END package (httpFinalizeOutput to skip) */
@@ -7524,7 +7658,7 @@ typedef struct HttpTx {
     HttpCache       *cache;                 /**< Cache control entry (only set if this request is being cached) */
     MprBuf          *cacheBuffer;           /**< Response caching buffer */
     ssize           cacheBufferLength;      /**< Current size of the cache buffer data */
-    cchar           *cachedContent;         /**< Retrieved cached response to send */
+    HttpCacheEntry  *cachedResponse;        /**< Retrieved cached response to send */
     MprOff          entityLength;           /**< Original content length before range subsetting */
     cchar           *errorDocument;         /**< Error document to render */
     cchar           *ext;                   /**< Filename extension */
@@ -8590,6 +8724,7 @@ typedef struct HttpWebSocket {
     cchar           *errorMsg;              /**< Error message for last I/O */
     cchar           *closeReason;           /**< Reason for closure */
     void            *data;                  /**< Custom data for applications (marked) */
+    void            *deflate;               /**< Permessage-deflate compression state (marked) */
     uchar           dataMask[4];            /**< Mask for data */
 } HttpWebSocket;
 
@@ -2723,8 +2723,11 @@ typedef struct MprBuf {
     ssize           growBy;             /**< Next growth increment to use */
     MprBufProc      refillProc;         /**< Auto-refill procedure */
     void            *refillArg;         /**< Refill arg - must be alloced memory */
+    int             flags;              /**< Buffer flags */
 } MprBuf;
 
+#define MPR_BUF_STATIC      0x1         /**< Buffer data is static, read-only memory that is not owned by the buffer */
+
 /**
     Add a null character to the buffer contents.
     @description Add a null byte but do not change the buffer content lengths. The null is added outside the
@@ -2782,6 +2785,19 @@ PUBLIC char *mprBufToString(MprBuf *buf);
  */
 PUBLIC MprBuf *mprCreateBuf(ssize initialSize, ssize maxSize);
 
+/**
+    Create a buffer that references static data
+    @description Create a full buffer that references the given data without copying. The data must be read-only
+        memory that outlives the buffer, such as a string constant. It is not marked by the garbage collector.
+        Writing to the buffer first copies the data into a newly allocated buffer.
+    @param data Static data
+    @param size Size of the data
+    @return a new buffer
+    @ingroup MprBuf
+    @stability Prototype
+ */
+PUBLIC MprBuf *mprCreateStaticBuf(cchar *data, ssize size);
+
 /**
     Clone a buffer
     @description Copy the buffer and contents into a newly allocated buffer
@@ -9540,6 +9556,17 @@ PUBLIC void *mprDestroyCache(MprCache *cache);
  */
 PUBLIC int mprExpireCacheItem(MprCache *cache, cchar *key, MprTicks expires);
 
+/**
+    Get the linked managed memory reference for a cached item.
+    @description The linked reference is not checked for expiry. Use #mprReadCache first to validate the item.
+    @param cache The cache instance object returned from #mprCreateCache.
+    @param key Cache item key
+    @return The linked reference or NULL if the item or link is not defined.
+    @ingroup MprCache
+    @stability Evolving
+ */
+PUBLIC void *mprGetCacheLink(MprCache *cache, cchar *key);
+
 /**
     Get the Cache statistics
     @param cache The cache instance object returned from #mprCreateCache.
@@ -9600,6 +9627,21 @@ PUBLIC void mprPruneCache(MprCache *cache);
   */
 PUBLIC char *mprReadCache(MprCache *cache, cchar *key, MprTime *modified, int64 *version);
 
+/**
+    Read an item and its linked reference from the cache.
+    @description This is similar to #mprReadCache but also returns the linked reference. The value and link are read
+        atomically so they match if the item is written via #mprWriteCacheWithLink.
+    @param cache The cache instance object returned from #mprCreateCache.
+    @param key Cache item key
+    @param modified Optional MprTime value reference to receive the last modified time of the cache item. Set to null
+        if not required.
+    @param link Reference to receive the linked reference. Set to NULL if the item or link is not defined.
+    @return The cache item value
+    @ingroup MprCache
+    @stability Prototype
+  */
+PUBLIC char *mprReadCacheWithLink(MprCache *cache, cchar *key, MprTime *modified, void **link);
+
 /**
     Remove items from the cache
     @param cache The cache instance object returned from #mprCreateCache.
@@ -9674,6 +9716,41 @@ PUBLIC int mprSetCacheLink(MprCache *cache, cchar *key, void *link);
 PUBLIC ssize mprWriteCache(MprCache *cache, cchar *key, cchar *value, MprTime modified, MprTicks lifespan,
         int64 version, int options);
 
+/**
+    Set a linked managed memory reference for a cached item and account for its memory.
+    @description This is similar to #mprSetCacheLink but the size of the linked reference is included when enforcing the
+        cache memory limit. The size is released when the item is removed or the link is replaced.
+    @param cache The cache instance object returned from #mprCreateCache.
+    @param key Cache item key to write
+    @param link Managed memory reference. May be NULL.
+    @param size Memory size in bytes to account for the linked reference.
+    @return Zero if successful, otherwise MPR_ERR_CANT_FIND if the key is not present in the cache.
+    @ingroup MprCache
+    @stability Prototype
+ */
+PUBLIC int mprWriteCacheLink(MprCache *cache, cchar *key, void *link, ssize size);
+
+/**
+    Write a cache item and its linked reference.
+    @description This writes the item value as #mprWriteCache with MPR_CACHE_SET and sets the linked reference as
+        #mprWriteCacheLink. Both are updated atomically so readers using #mprReadCacheWithLink never see the new value
+        without its link.
+    @param cache The cache instance object returned from #mprCreateCache.
+    @param key Cache item key to write
+    @param value Value to set for the cache item.
+    @param modified Value to set for the cache last modified time. If set to zero, the current time is obtained via
+        #mprGetTime.
+    @param lifespan Lifespan of the item in milliseconds.
+    @param link Managed memory reference. May be NULL.
+    @param size Memory size in bytes to account for the linked reference.
+    @return If writing the cache item was successful this call returns the number of bytes written. Otherwise a negative
+        MPR error code is returned.
+    @ingroup MprCache
+    @stability Prototype
+ */
+PUBLIC ssize mprWriteCacheWithLink(MprCache *cache, cchar *key, cchar *value, MprTime modified, MprTicks lifespan,
+        void *link, ssize size);
+
 /******************************** Mime Types **********************************/
 /**
     Mime Type hash table entry (the URL extension is the key)
@@ -4228,10 +4228,29 @@ PUBLIC MprBuf *mprCreateBuf(ssize initialSize, ssize maxSize)
 }
 
 
+PUBLIC MprBuf *mprCreateStaticBuf(cchar *data, ssize size)
+{
+    MprBuf      *bp;
+
+    if ((bp = mprAllocObj(MprBuf, manageBuf)) == 0) {
+        return 0;
+    }
+    bp->flags = MPR_BUF_STATIC;
+    bp->data = bp->start = (char*) data;
+    bp->end = bp->endbuf = (char*) &data[size];
+    bp->buflen = size;
+    bp->growBy = (size > 0) ? size : ME_BUFSIZE;
+    bp->maxsize = -1;
+    return bp;
+}
+
+
 static void manageBuf(MprBuf *bp, int flags)
 {
     if (flags & MPR_MANAGE_MARK) {
-        mprMark(bp->data);
+        if (!(bp->flags & MPR_BUF_STATIC)) {
+            mprMark(bp->data);
+        }
         mprMark(bp->refillArg);
     }
 }
@@ -4248,7 +4267,7 @@ PUBLIC MprBuf *mprCloneBuf(MprBuf *orig)
     bp->refillProc = orig->refillProc;
     bp->refillArg = orig->refillArg;
     if ((len = mprGetBufLength(orig)) > 0) {
-        memcpy(bp->data, orig->data, len);
+        memcpy(bp->data, orig->start, len);
         bp->end = &bp->data[len];
     }
     return bp;
@@ -4374,6 +4393,11 @@ PUBLIC void mprAdjustBufEnd(MprBuf *bp, ssize size)
     if (bp->end < bp->data) {
         bp->end = bp->data;
     }
+    if (bp->flags & MPR_BUF_STATIC) {
+        /* Static data is read-only. Trim the buffer so there is no space and writes will allocate */
+        bp->endbuf = bp->end;
+        bp->buflen = bp->endbuf - bp->data;
+    }
 }
 
 
@@ -4399,6 +4423,11 @@ PUBLIC void mprAdjustBufStart(MprBuf *bp, ssize size)
 
 PUBLIC void mprFlushBuf(MprBuf *bp)
 {
+    if (bp->flags & MPR_BUF_STATIC) {
+        /* Static data is read-only. Leave the buffer empty with no space so writes will allocate */
+        bp->data = bp->endbuf;
+        bp->buflen = 0;
+    }
     bp->start = bp->data;
     bp->end = bp->data;
 }
@@ -4494,7 +4523,7 @@ PUBLIC char *mprGetBufEnd(MprBuf *bp)
 
 PUBLIC int mprInsertCharToBuf(MprBuf *bp, int c)
 {
-    if (bp->start == bp->data) {
+    if (bp->start == bp->data || (bp->flags & MPR_BUF_STATIC)) {
         return MPR_ERR_BAD_STATE;
     }
     *--bp->start = c;
@@ -4527,7 +4556,7 @@ PUBLIC int mprPutCharToBuf(MprBuf *bp, int c)
 
     assert(bp->buflen == (bp->endbuf - bp->data));
 
-    space = bp->buflen - mprGetBufLength(bp);
+    space = mprGetBufSpace(bp);
     if (space < sizeof(char)) {
         if (mprGrowBuf(bp, 1) < 0) {
             return -1;
@@ -4663,6 +4692,7 @@ PUBLIC int mprGrowBuf(MprBuf *bp, ssize need)
     bp->start = newbuf + (bp->start - bp->data);
     bp->data = newbuf;
     bp->endbuf = &bp->data[bp->buflen];
+    bp->flags &= ~MPR_BUF_STATIC;
 
     /*
         Increase growBy to reduce overhead
@@ -4701,7 +4731,11 @@ PUBLIC void mprCompactBuf(MprBuf *bp)
         mprFlushBuf(bp);
         return;
     }
-    if (bp->start > bp->data) {
+    if (bp->flags & MPR_BUF_STATIC) {
+        /* Cannot move read-only data. Discard the consumed data instead */
+        bp->data = bp->start;
+        bp->buflen = bp->endbuf - bp->data;
+    } else if (bp->start > bp->data) {
         memmove(bp->data, bp->start, (bp->end - bp->start));
         bp->end -= (bp->start - bp->data);
         bp->start = bp->data;
@@ -4938,6 +4972,7 @@ typedef struct CacheItem
     char            *key;               /* Original key */
     char            *data;              /* Cache data */
     void            *link;              /* Linked managed reference */
+    ssize           linkSize;           /* Memory size accounted for the linked reference */
     MprTicks        lifespan;           /* Lifespan after each access to key (msec) */
     MprTicks        lastAccessed;       /* Last accessed time */
     MprTicks        expires;            /* Fixed expiry date. If zero, key is imortal. */
@@ -5139,6 +5174,32 @@ PUBLIC char *mprReadCache(MprCache *cache, cchar *key, MprTime *modified, int64
 }
 
 
+/*
+    Read an item and its linked reference. The value and link are read under one lock so they are consistent with
+    a concurrent mprWriteCacheWithLink.
+ */
+PUBLIC char *mprReadCacheWithLink(MprCache *cache, cchar *key, MprTime *modified, void **link)
+{
+    char    *result;
+
+    assert(cache);
+    assert(key);
+    assert(link);
+
+    if (cache->shared) {
+        cache = cache->shared;
+        assert(cache == shared);
+    }
+    lock(cache);
+    *link = 0;
+    if ((result = mprReadCache(cache, key, modified, 0)) != 0) {
+        *link = mprGetCacheLink(cache, key);
+    }
+    unlock(cache);
+    return result;
+}
+
+
 PUBLIC bool mprRemoveCache(MprCache *cache, cchar *key)
 {
     CacheItem   *item;
@@ -5154,7 +5215,7 @@ PUBLIC bool mprRemoveCache(MprCache *cache, cchar *key)
     lock(cache);
     if (key) {
         if ((item = mprLookupKey(cache->store, key)) != 0) {
-            cache->usedMem -= (slen(key) + slen(item->data));
+            cache->usedMem -= (slen(key) + slen(item->data) + item->linkSize);
             mprRemoveKey(cache->store, key);
             result = 1;
         } else {
@@ -5324,12 +5385,22 @@ PUBLIC void *mprGetCacheLink(MprCache *cache, cchar *key)
 
 
 PUBLIC int mprSetCacheLink(MprCache *cache, cchar *key, void *link)
+{
+    return mprWriteCacheLink(cache, key, link, 0);
+}
+
+
+/*
+    Set the linked reference and account for its size against the cache memory limit
+ */
+PUBLIC int mprWriteCacheLink(MprCache *cache, cchar *key, void *link, ssize size)
 {
     CacheItem   *item;
     MprKey      *kp;
 
     assert(cache);
     assert(key && *key);
+    assert(size >= 0);
 
     if (cache->shared) {
         cache = cache->shared;
@@ -5339,12 +5410,39 @@ PUBLIC int mprSetCacheLink(MprCache *cache, cchar *key, void *link)
     if ((kp = mprLookupKeyEntry(cache->store, key)) != 0) {
         item = (CacheItem*) kp->data;
         item->link = link;
+        cache->usedMem += (size - item->linkSize);
+        item->linkSize = size;
     }
     unlock(cache);
     return kp ? 0 : MPR_ERR_CANT_FIND;
 }
 
 
+/*
+    Write an item and set its linked reference under one lock so readers never see the new value without its link
+ */
+PUBLIC ssize mprWriteCacheWithLink(MprCache *cache, cchar *key, cchar *value, MprTime modified, MprTicks lifespan,
+    void *link, ssize size)
+{
+    ssize   len;
+
+    assert(cache);
+    assert(key && *key);
+    assert(value);
+
+    if (cache->shared) {
+        cache = cache->shared;
+        assert(cache == shared);
+    }
+    lock(cache);
+    if ((len = mprWriteCache(cache, key, value, modified, lifespan, 0, 0)) > 0) {
+        mprWriteCacheLink(cache, key, link, size);
+    }
+    unlock(cache);
+    return len;
+}
+
+
 static void removeItem(MprCache *cache, CacheItem *item)
 {
     assert(cache);
@@ -5355,7 +5453,7 @@ static void removeItem(MprCache *cache, CacheItem *item)
         (cache->notify)(cache, item->key, item->data, MPR_CACHE_NOTIFY_REMOVE);
     }
     mprRemoveKey(cache->store, item->key);
-    cache->usedMem -= (slen(item->key) + slen(item->data));
+    cache->usedMem -= (slen(item->key) + slen(item->data) + item->linkSize);
     unlock(cache);
 }
 
@@ -295,6 +295,9 @@
 #ifndef ME_COM_SSL
     #define ME_COM_SSL 1
 #endif
+#ifndef ME_COM_TCC
+    #define ME_COM_TCC 0
+#endif
 #ifndef ME_COM_VXWORKS
     #define ME_COM_VXWORKS 0
 #endif
@@ -14,6 +14,7 @@
 static void addValidations(void);
 static void formatFieldForJson(MprBuf *buf, EdiField *fp, int flags);
 static void manageEdiService(EdiService *es, int flags);
+static void manageEdiCursor(EdiCursor *cursor, int flags);
 static void manageEdiGrid(EdiGrid *grid, int flags);
 static bool validateField(Edi *edi, EdiRec *rec, cchar *columnName, cchar *value);
 
@@ -147,6 +148,67 @@ PUBLIC int ediAddValidation(Edi *edi, cchar *name, cchar *tableName, cchar *colu
 }
 
 
+/*
+    Aggregate column values. Providers without an aggregate capability are aggregated by reading the matching
+    records via a cursor.
+ */
+PUBLIC int ediAggregate(Edi *edi, cchar *tableName, cchar *columnName, cchar *query, int op, double *result)
+{
+    EdiCursor   *cursor;
+    EdiRec      *rec;
+    cchar       *value;
+    char        *end;
+    double      num, total;
+    int         count;
+
+    assert(result);
+
+    *result = 0;
+    if (!edi || !edi->provider) {
+        return MPR_ERR_BAD_STATE;
+    }
+    if (op < EDI_AGG_COUNT || op > EDI_AGG_AVG) {
+        return MPR_ERR_BAD_ARGS;
+    }
+    if (edi->provider->aggregate) {
+        return edi->provider->aggregate(edi, tableName, columnName, query, op, result);
+    }
+    if (ediLookupField(edi, tableName, columnName) < 0) {
+        return MPR_ERR_CANT_FIND;
+    }
+    if ((cursor = ediOpenCursor(edi, tableName, query)) == 0) {
+        return MPR_ERR_CANT_FIND;
+    }
+    total = 0;
+    count = 0;
+    while ((rec = ediNextRec(cursor)) != 0) {
+        if ((value = ediGetFieldValue(rec, columnName)) == 0 || *value == '\0' || isspace((uchar) *value)) {
+            continue;
+        }
+        num = strtod(value, &end);
+        if (*end != '\0') {
+            continue;
+        }
+        if (op == EDI_AGG_MIN) {
+            total = (count == 0 || num < total) ? num : total;
+        } else if (op == EDI_AGG_MAX) {
+            total = (count == 0 || num > total) ? num : total;
+        } else {
+            total += num;
+        }
+        count++;
+    }
+    ediCloseCursor(cursor);
+    if (op == EDI_AGG_COUNT) {
+        total = count;
+    } else if (op == EDI_AGG_AVG && count > 0) {
+        total /= count;
+    }
+    *result = total;
+    return count;
+}
+
+
 static bool validateField(Edi *edi, EdiRec *rec, cchar *columnName, cchar *value)
 {
     EdiValidation   *vp;
@@ -609,6 +671,18 @@ PUBLIC Edi *ediClone(Edi *edi)
 }
 
 
+PUBLIC int ediConfigure(Edi *edi, MprJson *options)
+{
+    if (!edi || !edi->provider) {
+        return MPR_ERR_BAD_STATE;
+    }
+    if (!edi->provider->configure || !options) {
+        return 0;
+    }
+    return edi->provider->configure(edi, options);
+}
+
+
 PUBLIC EdiGrid *ediQuery(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list vargs)
 {
     if (!edi || !edi->provider) {
@@ -651,6 +725,64 @@ PUBLIC EdiGrid *ediFindGrid(Edi *edi, cchar *tableName, cchar *select)
 }
 
 
+PUBLIC EdiCursor *ediOpenCursor(Edi *edi, cchar *tableName, cchar *select)
+{
+    EdiCursor   *cursor;
+
+    if (!edi || !edi->provider || !tableName) {
+        return 0;
+    }
+    if ((cursor = mprAllocObj(EdiCursor, manageEdiCursor)) == 0) {
+        return 0;
+    }
+    cursor->edi = edi;
+    cursor->tableName = sclone(tableName);
+    if (edi->provider->openCursor) {
+        if (edi->provider->openCursor(cursor, select) < 0) {
+            return 0;
+        }
+    } else {
+        /*
+            Provider does not support cursors. Iterate over the full result.
+         */
+        if ((cursor->grid = edi->provider->findGrid(edi, tableName, select)) == 0) {
+            return 0;
+        }
+        cursor->count = cursor->grid->count;
+    }
+    return cursor;
+}
+
+
+PUBLIC EdiRec *ediNextRec(EdiCursor *cursor)
+{
+    if (!cursor || cursor->closed) {
+        return 0;
+    }
+    if (cursor->grid) {
+        if (cursor->index < cursor->grid->nrecords) {
+            return cursor->grid->records[cursor->index++];
+        }
+        return 0;
+    }
+    return cursor->edi->provider->nextRec(cursor);
+}
+
+
+PUBLIC void ediCloseCursor(EdiCursor *cursor)
+{
+    if (!cursor || cursor->closed) {
+        return;
+    }
+    cursor->closed = 1;
+    if (!cursor->grid && cursor->edi->provider->closeCursor) {
+        cursor->edi->provider->closeCursor(cursor);
+    }
+    cursor->grid = 0;
+    cursor->data = 0;
+}
+
+
 PUBLIC EdiRec *ediFindRec(Edi *edi, cchar *tableName, cchar *select)
 {
     EdiGrid     *grid;
@@ -678,6 +810,31 @@ PUBLIC EdiRec *ediReadRec(Edi *edi, cchar *tableName, cchar *key)
 }
 
 
+PUBLIC EdiGrid *ediReadRecs(Edi *edi, cchar *tableName, int argc, cchar **keys)
+{
+    EdiGrid     *grid;
+    EdiRec      *rec;
+    int         i;
+
+    if (!edi || !edi->provider) {
+        return 0;
+    }
+    if (edi->provider->readRecs) {
+        return edi->provider->readRecs(edi, tableName, argc, keys);
+    }
+    if ((grid = ediCreateBareGrid(edi, tableName, argc)) == 0) {
+        return 0;
+    }
+    grid->nrecords = 0;
+    for (i = 0; i < argc; i++) {
+        if ((rec = edi->provider->readRec(edi, tableName, keys[i])) != 0) {
+            grid->records[grid->nrecords++] = rec;
+        }
+    }
+    return grid;
+}
+
+
 #if DEPRECATED || 1
 PUBLIC EdiRec *ediFindRecWhere(Edi *edi, cchar *tableName, cchar *fieldName, cchar *operation, cchar *value)
 {
@@ -1079,16 +1236,89 @@ static MprList *joinColumns(MprList *cols, EdiGrid *grid, MprHash *grids, int jo
 }
 
 
+/*
+    Return the index of the key field of a record
+ */
+static int getKeyField(EdiRec *rec)
+{
+    EdiField    *fp;
+
+    for (fp = rec->fields; fp < &rec->fields[rec->nfields]; fp++) {
+        if (fp->flags & EDI_KEY) {
+            return (int) (fp - rec->fields);
+        }
+    }
+    for (fp = rec->fields; fp < &rec->fields[rec->nfields]; fp++) {
+        if (smatch(fp->name, "id")) {
+            return (int) (fp - rec->fields);
+        }
+    }
+    return 0;
+}
+
+
+/*
+    Index the records of a foreign grid by key
+ */
+static MprHash *indexGrid(EdiGrid *grid)
+{
+    MprHash     *index;
+    EdiRec      *rec;
+    cchar       *key;
+    int         r, keyField;
+
+    index = mprCreateHash(grid->nrecords, MPR_HASH_STABLE);
+    if (grid->nrecords > 0) {
+        keyField = getKeyField(grid->records[0]);
+        for (r = 0; r < grid->nrecords; r++) {
+            rec = grid->records[r];
+            if ((key = rec->fields[keyField].value) != 0) {
+                mprAddKey(index, key, rec);
+            }
+        }
+    }
+    return index;
+}
+
+
+/*
+    Read the foreign records for keys that are not in the index
+ */
+static void readMissingKeys(Edi *edi, cchar *tableName, MprHash *index, MprList *keys)
+{
+    EdiGrid     *grid;
+    EdiRec      *rec;
+    cchar       *key;
+    int         keyField, nkeys, r;
+
+    if ((nkeys = mprGetListLength(keys)) == 0) {
+        return;
+    }
+    if ((grid = ediReadRecs(edi, tableName, nkeys, (cchar**) keys->items)) == 0 || grid->nrecords == 0) {
+        return;
+    }
+    keyField = getKeyField(grid->records[0]);
+    for (r = 0; r < grid->nrecords; r++) {
+        rec = grid->records[r];
+        if ((key = rec->fields[keyField].value) != 0) {
+            mprAddKey(index, key, rec);
+        }
+    }
+}
+
+
 /*
     Join grids using an INNER JOIN. All rows are returned. List of grids to join must be null terminated.
+    Foreign grids are indexed by key. Foreign records not present in the supplied grids are read from the database
+    in batches.
  */
 PUBLIC EdiGrid *ediJoin(Edi *edi, ...)
 {
     EdiGrid     *primary, *grid, *result, *current;
-    EdiRec      *rec;
+    EdiRec      *rec, *foreign;
     EdiField    *dest, *fp;
-    MprList     *cols, *rows;
-    MprHash     *grids;
+    MprList     *cols, *rows, *keys;
+    MprHash     *grids, *indexes, *index, *pending;
     Col         *col;
     va_list     vgrids;
     cchar       *keyValue;
@@ -1096,20 +1326,24 @@ PUBLIC EdiGrid *ediJoin(Edi *edi, ...)
 
     va_start(vgrids, edi);
     if ((primary = va_arg(vgrids, EdiGrid*)) == 0) {
+        va_end(vgrids);
         return 0;
     }
     if (primary->nrecords == 0) {
+        va_end(vgrids);
         return ediCreateBareGrid(edi, NULL, 0);
     }
     /*
-        Build list of grids to join
+        Build list of grids to join and index each foreign grid by key
      */
     grids = mprCreateHash(0, MPR_HASH_STABLE);
+    indexes = mprCreateHash(0, MPR_HASH_STABLE);
     for (;;) {
         if ((grid = va_arg(vgrids, EdiGrid*)) == 0) {
             break;
         }
         mprAddKey(grids, grid->tableName, grid);
+        mprAddKey(indexes, grid->tableName, indexGrid(grid));
     }
     va_end(vgrids);
 
@@ -1118,8 +1352,30 @@ PUBLIC EdiGrid *ediJoin(Edi *edi, ...)
      */
     cols = joinColumns(mprCreateList(0, 0), primary, grids, -1, 1);
     nfields = mprGetListLength(cols);
-    rows = mprCreateList(0, 0);
 
+    /*
+        Read any foreign records referenced by the primary grid that were not supplied
+     */
+    current = 0;
+    for (ITERATE_ITEMS(cols, col, next)) {
+        if (col->grid == primary || col->grid == current) {
+            continue;
+        }
+        current = col->grid;
+        index = mprLookupKey(indexes, current->tableName);
+        pending = mprCreateHash(0, MPR_HASH_STATIC_VALUES);
+        keys = mprCreateList(0, 0);
+        for (r = 0; r < primary->nrecords; r++) {
+            keyValue = primary->records[r]->fields[col->joinField].value;
+            if (keyValue && !mprLookupKey(index, keyValue) && !mprLookupKey(pending, keyValue)) {
+                mprAddKey(pending, keyValue, LTOP(1));
+                mprAddItem(keys, keyValue);
+            }
+        }
+        readMissingKeys(edi, current->tableName, index, keys);
+    }
+
+    rows = mprCreateList(primary->nrecords, 0);
     for (r = 0; r < primary->nrecords; r++) {
         if ((rec = ediCreateBareRec(edi, NULL, nfields)) == 0) {
             assert(0);
@@ -1128,6 +1384,7 @@ PUBLIC EdiGrid *ediJoin(Edi *edi, ...)
         mprAddItem(rows, rec);
         dest = rec->fields;
         current = 0;
+        foreign = 0;
         for (ITERATE_ITEMS(cols, col, next)) {
             if (col->grid == primary) {
                 *dest = primary->records[r]->fields[col->field];
@@ -1135,10 +1392,11 @@ PUBLIC EdiGrid *ediJoin(Edi *edi, ...)
                 if (col->grid != current) {
                     current = col->grid;
                     keyValue = primary->records[r]->fields[col->joinField].value;
-                    rec = ediReadRec(edi, col->grid->tableName, keyValue);
+                    index = mprLookupKey(indexes, current->tableName);
+                    foreign = keyValue ? mprLookupKey(index, keyValue) : 0;
                 }
-                if (rec) {
-                    fp = &rec->fields[col->field];
+                if (foreign) {
+                    fp = &foreign->fields[col->field];
                     *dest = *fp;
                     dest->name = sfmt("%s.%s", col->grid->tableName, fp->name);
                 } else {
@@ -1179,6 +1437,17 @@ PUBLIC void ediManageEdiRec(EdiRec *rec, int flags)
 }
 
 
+static void manageEdiCursor(EdiCursor *cursor, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(cursor->edi);
+        mprMark(cursor->tableName);
+        mprMark(cursor->data);
+        mprMark(cursor->grid);
+    }
+}
+
+
 static void manageEdiGrid(EdiGrid *grid, int flags)
 {
     int     r;
@@ -1505,30 +1774,26 @@ PUBLIC EdiRec *ediSetFields(EdiRec *rec, MprJson *params)
 }
 
 
-typedef struct GridSort {
-    int     sortColumn;         /**< Column to sort on */
-    int     sortOrder;          /**< Sort order: ascending == 1, descending == -1 */
-} GridSort;
+/*
+    Sort item. The sort field value is converted once per record before sorting.
+ */
+typedef struct GridSortItem {
+    EdiRec      *rec;               /**< Record to sort */
+    cchar       *str;               /**< String sort value */
+    int64       num;                /**< Numeric sort value */
+} GridSortItem;
 
-static int sortRec(EdiRec **r1, EdiRec **r2, GridSort *gs)
+static int sortRec(GridSortItem *i1, GridSortItem *i2, int *sortOrder)
 {
-    EdiField    *f1, *f2;
-    int64       v1, v2;
-
-    f1 = &(*r1)->fields[gs->sortColumn];
-    f2 = &(*r2)->fields[gs->sortColumn];
-    if (f1->type == EDI_TYPE_INT) {
-        v1 = stoi(f1->value);
-        v2 = stoi(f2->value);
-        if (v1 < v2) {
-            return - gs->sortOrder;
-        } else if (v1 > v2) {
-            return gs->sortOrder;
-        }
-        return 0;
-    } else {
-        return scmp(f1->value, f2->value) * gs->sortOrder;
+    if (i1->str || i2->str) {
+        return scmp(i1->str, i2->str) * *sortOrder;
     }
+    if (i1->num < i2->num) {
+        return - *sortOrder;
+    } else if (i1->num > i2->num) {
+        return *sortOrder;
+    }
+    return 0;
 }
 
 
@@ -1553,15 +1818,32 @@ static int lookupGridField(EdiGrid *grid, cchar *name)
 //  FUTURE - document
 PUBLIC EdiGrid *ediSortGrid(EdiGrid *grid, cchar *sortColumn, int sortOrder)
 {
-    GridSort    gs;
+    GridSortItem    *items, *item;
+    EdiField        *fp;
+    int             column, numeric, r;
 
     if (grid->nrecords == 0) {
         return grid;
     }
     grid = ediCloneGrid(grid);
-    gs.sortColumn = lookupGridField(grid, sortColumn);
-    gs.sortOrder = sortOrder;
-    mprSort(grid->records, grid->nrecords, sizeof(EdiRec*), (MprSortProc) sortRec, &gs);
+    if ((column = lookupGridField(grid, sortColumn)) < 0) {
+        return grid;
+    }
+    if ((items = mprAlloc(grid->nrecords * sizeof(GridSortItem))) == 0) {
+        return 0;
+    }
+    numeric = grid->records[0]->fields[column].type == EDI_TYPE_INT;
+    for (r = 0; r < grid->nrecords; r++) {
+        item = &items[r];
+        item->rec = grid->records[r];
+        fp = &item->rec->fields[column];
+        item->str = numeric ? 0 : fp->value;
+        item->num = numeric ? stoi(fp->value) : 0;
+    }
+    mprSort(items, grid->nrecords, sizeof(GridSortItem), (MprSortProc) sortRec, &sortOrder);
+    for (r = 0; r < grid->nrecords; r++) {
+        grid->records[r] = items[r].rec;
+    }
     return grid;
 }
 
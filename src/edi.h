@@ -174,6 +174,23 @@ typedef struct EdiGrid {
     EdiRec          *records[ARRAY_FLEX];/**< Grid records */
 } EdiGrid;
 
+/**
+    Cursor structure
+    @description A cursor returns the records matching a query one at a time so that large results need not be
+        materialized in a grid. Cursors may hold database resources and should be closed via ediCloseCursor.
+        Cursors that are not closed hold their resources until the database is closed.
+    @defgroup EdiCursor EdiCursor
+ */
+typedef struct EdiCursor {
+    struct Edi      *edi;               /**< Database handle */
+    cchar           *tableName;         /**< Base table name for the cursor */
+    void            *data;              /**< Provider cursor state */
+    EdiGrid         *grid;              /**< Result grid if the provider does not support cursors */
+    int             index;              /**< Index of the next record in grid */
+    int             count;              /**< Total count of available records matching query. Set when exhausted */
+    bool            closed;             /**< Cursor has been closed */
+} EdiCursor;
+
 /*
     Database flags
  */
@@ -183,6 +200,17 @@ typedef struct EdiGrid {
 #define EDI_LITERAL         0x8         /**< Literal schema in ediOpen source parameter */
 #define EDI_SUPPRESS_SAVE   0x10        /**< Temporarily suppress auto-save */
 #define EDI_PRIVATE         0x20        /**< Create private clone of the database */
+#define EDI_COLUMNAR        0x40        /**< Store table data by column */
+#define EDI_BINARY          0x80        /**< Save database in binary snapshot format */
+
+/*
+    Aggregate operations
+ */
+#define EDI_AGG_COUNT       1           /**< Count of numeric values */
+#define EDI_AGG_SUM         2           /**< Sum of numeric values */
+#define EDI_AGG_MIN         3           /**< Minimum numeric value */
+#define EDI_AGG_MAX         4           /**< Maximum numeric value */
+#define EDI_AGG_AVG         5           /**< Average of numeric values */
 
 typedef int (*EdiMigration)(struct Edi *db);
 
@@ -251,6 +279,12 @@ typedef struct EdiProvider {
     int       (*save)(Edi *edi);
     int       (*updateField)(Edi *edi, cchar *tableName, cchar *key, cchar *fieldName, cchar *value);
     int       (*updateRec)(Edi *edi, EdiRec *rec);
+    int       (*configure)(Edi *edi, MprJson *options);
+    int       (*openCursor)(EdiCursor *cursor, cchar *query);
+    EdiRec    *(*nextRec)(EdiCursor *cursor);
+    void      (*closeCursor)(EdiCursor *cursor);
+    EdiGrid   *(*readRecs)(Edi *edi, cchar *tableName, int argc, cchar **keys);
+    int       (*aggregate)(Edi *edi, cchar *tableName, cchar *columnName, cchar *query, int op, double *result);
 } EdiProvider;
 
 /*************************** EDI Interface Wrappers **************************/
@@ -274,7 +308,8 @@ PUBLIC int ediAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type,
     @param edi Database handle
     @param tableName Database table name
     @param columnName Database column name
-    @param indexName Ignored. Set to null.
+    @param indexName Index name. The MDB provider permits any column to be indexed and uses the column name if null.
+        Equality queries on indexed columns are resolved via the index.
     @return Zero if successful. Otherwise a negative MPR error code.
     @ingroup Edi
     @stability Evolving
@@ -315,8 +350,27 @@ PUBLIC int ediAddTable(Edi *edi, cchar *tableName);
  */
 PUBLIC int ediAddValidation(Edi *edi, cchar *name, cchar *tableName, cchar *columnName, cvoid *data);
 
+/**
+    Aggregate the values of a column
+    @description Compute an aggregate over the numeric values of a column in the records matching a query.
+        Null values and values that are not numeric are ignored. Providers that can aggregate without reading
+        records do so. Otherwise the matching records are read via a cursor.
+    @param edi Database handle
+    @param tableName Database table name
+    @param columnName Database column name
+    @param query Query expression as used by #ediFindGrid. Set to null to aggregate all records.
+    @param op Aggregate operation. Set to one of EDI_AGG_AVG, EDI_AGG_COUNT, EDI_AGG_MAX, EDI_AGG_MIN or EDI_AGG_SUM.
+    @param result Set to the aggregate value. Set to zero if no values are aggregated.
+    @return The number of values aggregated. Otherwise a negative MPR error code.
+    @ingroup Edi
+    @stability Prototype
+ */
+PUBLIC int ediAggregate(Edi *edi, cchar *tableName, cchar *columnName, cchar *query, int op, double *result);
+
 /**
     Change a column schema definition
+    @description If the column type is changed, the "mdb" provider converts existing values to the new type.
+        Values that cannot be converted are kept as strings.
     @param edi Database handle
     @param tableName Database table name
     @param columnName Database column name
@@ -338,6 +392,15 @@ PUBLIC int ediChangeColumn(Edi *edi, cchar *tableName, cchar *columnName, int ty
  */
 PUBLIC void ediClose(Edi *edi);
 
+/**
+    Close a cursor
+    @description This releases the database resources held by the cursor. It is safe to close a cursor more than once.
+    @param cursor Cursor returned from ediOpenCursor
+    @ingroup Edi
+    @stability Prototype
+ */
+PUBLIC void ediCloseCursor(EdiCursor *cursor);
+
 /**
     Clone a grid
     @param grid to clone
@@ -347,6 +410,24 @@ PUBLIC void ediClose(Edi *edi);
  */
 PUBLIC EdiGrid *ediCloneGrid(EdiGrid *grid);
 
+/**
+    Configure a database
+    @description This applies provider specific options to an open database. The "sdb" provider supports:
+        @arg readers -- Number of read-only connections used for concurrent SELECT queries.
+        @arg wal -- Set to true to enable the WAL journal mode. Read-only connections require WAL mode. This persistently
+            changes the database file. Defaults to false unless the database is already in WAL mode.
+        @arg synchronous -- SQLite synchronous setting. Set to "off", "normal", "full" or "extra".
+        @arg cacheSize -- Page cache size per connection. May use suffixes such as "MB".
+        @arg mmapSize -- Memory map size per connection. May use suffixes such as "MB".
+    Providers without options ignore this call.
+    @param edi Database handle
+    @param options JSON object of options
+    @return Zero if successful. Otherwise a negative MPR error code.
+    @ingroup Edi
+    @stability Prototype
+ */
+PUBLIC int ediConfigure(Edi *edi, MprJson *options);
+
 /**
     Create a new record based on the table's schema.
     @description This will create an empty record using the given database tableName to supply the record schema. It will
@@ -498,6 +579,9 @@ PUBLIC cchar *ediGridAsJson(EdiGrid *grid, int flags);
 
 /**
     Join grids
+    @description The first grid is the primary grid. Fields named "tableNameId" in the primary grid are joined with
+        the record of the same key in the following grid of that table name. Foreign records not present in the
+        supplied grids are read from the database.
     @param edi Database handle
     @param ... Null terminated list of data grids. These are instances of EdiGrid.
     @return A joined grid.
@@ -548,6 +632,11 @@ PUBLIC EdiProvider *ediLookupProvider(cchar *providerName);
         @arg EDI_AUTO_SAVE -- Auto-save database if modified in memory. This option is only supported by the "mdb" provider.
         @arg EDI_NO_SAVE  -- Prevent saving to disk. This option is only supported by the "mdb" provider.
         @arg EDI_LITERAL -- Literal schema in ediOpen source parameter. This option is only supported by the "mdb" provider.
+        @arg EDI_COLUMNAR -- Store table data in per-column arrays. This speeds scanning queries on large tables.
+            This option is only supported by the "mdb" provider.
+        @arg EDI_BINARY -- Save the database in a compact binary snapshot format. This is also selected if the
+            database path has a ".mdbx" extension. Binary and JSON databases are both detected when loading.
+            This option is only supported by the "mdb" provider.
     @return If successful, returns an EDI database instance object. Otherwise returns zero.
     @ingroup Edi
     @stability Evolving
@@ -624,6 +713,29 @@ PUBLIC EdiField ediReadField(Edi *edi, cchar *tableName, cchar *key, cchar *fiel
  */
 PUBLIC EdiGrid *ediFindGrid(Edi *edi, cchar *tableName, cchar *query);
 
+/**
+    Open a cursor over matching records in a table
+    @description This is similar to ediFindGrid but returns the matching records one at a time via ediNextRec rather
+        than reading them all into a grid. The cursor should be closed via ediCloseCursor. For the "sdb" provider, an
+        open cursor holds a database connection until it is closed or the database is closed.
+    @param edi Database handle
+    @param tableName Database table name
+    @param query SQL like query expression. See ediFindGrid for the query format.
+    @return A cursor object. Returns NULL if the table or query is invalid.
+    @ingroup Edi
+    @stability Prototype
+ */
+PUBLIC EdiCursor *ediOpenCursor(Edi *edi, cchar *tableName, cchar *query);
+
+/**
+    Read the next record from a cursor
+    @param cursor Cursor returned from ediOpenCursor
+    @return The next matching record. Returns NULL when there are no more records.
+    @ingroup Edi
+    @stability Prototype
+ */
+PUBLIC EdiRec *ediNextRec(EdiCursor *cursor);
+
 /**
     Read one record.
     @description This runs a simple query on the database and selects the first matching record. The query selects
@@ -651,6 +763,20 @@ PUBLIC EdiRec *ediFindRec(Edi *edi, cchar *tableName, cchar *query);
  */
 PUBLIC EdiRec *ediReadRec(Edi *edi, cchar *tableName, cchar *key);
 
+/**
+    Read records by key.
+    @description Read the records from the given table identified by a list of key values. Providers that can
+        read many keys with one query do so. Otherwise each key is read in turn. Keys that are not found are ignored.
+    @param edi Database handle
+    @param tableName Database table name
+    @param argc Number of keys
+    @param keys Array of key values
+    @return A grid containing the records found. The order of records is not defined.
+    @ingroup Edi
+    @stability Prototype
+ */
+PUBLIC EdiGrid *ediReadRecs(Edi *edi, cchar *tableName, int argc, cchar **keys);
+
 #if DEPRECATED || 1
 /**
     Read a table.
@@ -721,7 +847,7 @@ PUBLIC int edRemoveColumn(Edi *edi, cchar *tableName, cchar *columnName);
     Remove a table index.
     @param edi Database handle
     @param tableName Database table name
-    @param indexName Ignored. Set to null. This call will remove the table index.
+    @param indexName Index name. For MDB, this may be the index or column name. If null, MDB removes all table indexes.
     @return Zero if successful. Otherwise a negative MPR error code.
     @ingroup Edi
     @stability Evolving
@@ -37,6 +37,8 @@ typedef struct App {
     cchar       *combinePath;           /* Output filename for combine compilations */
     MprFile     *combineFile;           /* Output file for combine compilations */
     MprList     *combineItems;          /* Items to invoke from Init */
+    MprList     *combineObjects;        /* Objects to link for incremental combine compilations */
+    MprHash     *combineViews;          /* Views for the combine view table. Key is view path, data is view proc */
 
     MprList     *routes;                /* Routes to process */
     EspRoute    *eroute;                /* Selected ESP route to build */
@@ -48,6 +50,8 @@ typedef struct App {
     MprHash     *build;                 /* Items to build */
     MprHash     *built;                 /* Items that have been built */
     MprHash     *targets;               /* Command line targets */
+    MprList     *pending;               /* Compile jobs waiting to run */
+    MprList     *running;               /* Compile jobs currently running */
     EdiGrid     *migrations;            /* Migrations table */
 
     cchar       *command;               /* Compilation or link command */
@@ -68,6 +72,8 @@ typedef struct App {
 
     int         compileMode;            /* Debug or release compilation */
     int         error;                  /* Any processing error */
+    int         jobs;                   /* Maximum number of concurrent compile jobs */
+    int         queued;                 /* Number of compile jobs queued */
     int         keep;                   /* Keep source */
     int         force;                  /* Force the requested action, ignoring unfullfilled dependencies */
     int         quiet;                  /* Don't trace progress */
@@ -83,6 +89,21 @@ typedef struct App {
     int         why;                    /* Why rebuild */
 } App;
 
+/*
+    Compile job. Runs the compile and optional link commands for one source file.
+ */
+typedef struct EspJob {
+    HttpRoute   *route;                 /* Route owning the source */
+    MprCmd      *cmd;                   /* Running command */
+    cchar       *command;               /* Expanded command line */
+    cchar       *source;                /* Source file */
+    cchar       *csource;               /* C source to compile */
+    cchar       *module;                /* Output module */
+    int         kind;                   /* Kind of source (ESP_VIEW, ESP_PAGE...) */
+    int         linking;                /* Running the link command */
+    int         object;                 /* Compile to an object for an incremental combined module */
+} EspJob;
+
 static App       *app;                  /* Top level application object */
 static Esp       *esp;                  /* ESP control object */
 static Http      *http;                 /* HTTP service object */
@@ -127,6 +148,12 @@ static void compile(int argc, char **argv);
 static void compileFile(HttpRoute *route, cchar *source, int kind);
 static void compileCombined(HttpRoute *route);
 static void compileItems(HttpRoute *route);
+static void addCombineItem(HttpRoute *route, cchar *source, int kind);
+static void compileObjects(HttpRoute *route, cchar *name);
+static int getBuildKind(cchar *item);
+static char *getCombineEntry(cchar *name, bool declare);
+static bool writeViewTable(MprBuf *buf);
+static void completeJob(EspJob *job);
 static App *createApp(Mpr *mpr);
 static void createMigration(cchar *name, cchar *table, cchar *comment, int fieldCount, char **fields);
 static void editValue(int argc, char **argv);
@@ -153,6 +180,7 @@ static void makeEspDir(cchar *dir);
 static void makeEspFile(cchar *path, cchar *data, ssize len);
 static MprHash *makeTokens(cchar *path, MprHash *other);
 static void manageApp(App *app, int flags);
+static void manageJob(EspJob *job, int flags);
 static void migrate(int argc, char **argv);
 static int parseArgs(int argc, char **argv);
 static void parseCommand(int argc, char **argv);
@@ -171,6 +199,9 @@ static void setConfigValue(MprJson *config, cchar *key, cchar *value);
 static void setProfile(cchar *mode);
 static int sortFiles(MprDirEntry **d1, MprDirEntry **d2);
 static void qtrace(cchar *tag, cchar *fmt, ...);
+static void queueJob(HttpRoute *route, cchar *source, cchar *csource, cchar *module, int kind);
+static void runJobs(bool all);
+static int startJob(EspJob *job, cchar *command);
 static void trace(cchar *tag, cchar *fmt, ...);
 static void usageError(void);
 static void user(int argc, char **argv);
@@ -217,10 +248,26 @@ static App *createApp(Mpr *mpr)
     app->listen = sclone(ESP_LISTEN);
     app->paksDir = sclone(ESP_PAKS_DIR);
     app->cipher = sclone("blowfish");
+    if ((app->jobs = (int) mprGetMemStats()->cpuCores) <= 0) {
+        app->jobs = 1;
+    }
     return app;
 }
 
 
+static void manageJob(EspJob *job, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(job->route);
+        mprMark(job->cmd);
+        mprMark(job->command);
+        mprMark(job->source);
+        mprMark(job->csource);
+        mprMark(job->module);
+    }
+}
+
+
 static void manageApp(App *app, int flags)
 {
     if (flags & MPR_MANAGE_MARK) {
@@ -232,6 +279,8 @@ static void manageApp(App *app, int flags)
         mprMark(app->cipher);
         mprMark(app->combineFile);
         mprMark(app->combineItems);
+        mprMark(app->combineObjects);
+        mprMark(app->combineViews);
         mprMark(app->combinePath);
         mprMark(app->command);
         mprMark(app->config);
@@ -259,9 +308,11 @@ static void manageApp(App *app, int flags)
         mprMark(app->paksCacheDir);
         mprMark(app->paksDir);
         mprMark(app->password);
+        mprMark(app->pending);
         mprMark(app->platform);
         mprMark(app->route);
         mprMark(app->routes);
+        mprMark(app->running);
         mprMark(app->table);
         mprMark(app->targets);
         mprMark(app->title);
@@ -348,6 +399,16 @@ static int parseArgs(int argc, char **argv)
         } else if (smatch(argp, "force") || smatch(argp, "f")) {
             app->force = 1;
 
+        } else if (smatch(argp, "jobs") || smatch(argp, "j")) {
+            if (argind >= argc) {
+                usageError();
+            } else {
+                app->jobs = (int) stoi(argv[++argind]);
+                if (app->jobs <= 0) {
+                    app->jobs = 1;
+                }
+            }
+
         } else if (smatch(argp, "keep") || smatch(argp, "k")) {
             app->keep = 1;
 
@@ -1164,6 +1225,7 @@ static void migrate(int argc, char **argv)
                 WARNING: GC may occur while compiling
              */
             compileFile(route, file, ESP_MIGRATION);
+            runJobs(1);
             if (app->error) {
                 return;
             }
@@ -1595,19 +1657,61 @@ static MprList *getRoutes()
 }
 
 
-static int runEspCommand(HttpRoute *route, cchar *command, cchar *csource, cchar *module)
+/*
+    Collect command output
+ */
+static void commandCallback(MprCmd *cmd, int channel, void *data)
+{
+    MprBuf      *buf;
+    ssize       len, space;
+    int         errCode;
+
+    if (channel == MPR_CMD_STDOUT) {
+        buf = cmd->stdoutBuf;
+    } else if (channel == MPR_CMD_STDERR) {
+        buf = cmd->stderrBuf;
+    } else {
+        return;
+    }
+    space = mprGetBufSpace(buf);
+    if (space < (ME_BUFSIZE / 4)) {
+        if (mprGrowBuf(buf, ME_BUFSIZE) < 0) {
+            mprCloseCmdFd(cmd, channel);
+            return;
+        }
+        space = mprGetBufSpace(buf);
+    }
+    len = mprReadCmd(cmd, channel, mprGetBufEnd(buf), space);
+    errCode = mprGetError();
+    if (len <= 0) {
+        if (len == 0 || (len < 0 && !(errCode == EAGAIN || errCode == EWOULDBLOCK))) {
+            mprCloseCmdFd(cmd, channel);
+            return;
+        }
+    } else {
+        mprAdjustBufEnd(buf, len);
+    }
+    mprAddNullToBuf(buf);
+    mprEnableCmdEvents(cmd, channel);
+}
+
+
+/*
+    Start a compile or link command without waiting for it to complete. The expanded command is saved in app->command.
+ */
+static MprCmd *startEspCommand(HttpRoute *route, cchar *command, cchar *csource, cchar *module)
 {
     MprCmd      *cmd;
     MprList     *elist;
     MprKey      *var;
     EspRoute    *eroute;
-    cchar       **env;
-    char        *err, *out;
+    cchar       **argv, **env;
+    int         argc;
 
     eroute = route->eroute;
     if ((app->command = espExpandCommand(route, command, csource, module)) == 0) {
         fail("Missing EspCompile directive for %s", csource);
-        return MPR_ERR_CANT_READ;
+        return 0;
     }
     mprLog("", 4, "command: %s", app->command);
     if (eroute->env) {
@@ -1620,20 +1724,49 @@ static int runEspCommand(HttpRoute *route, cchar *command, cchar *csource, cchar
     } else {
         env = 0;
     }
+    if ((argc = mprMakeArgv(app->command, &argv, 0)) < 0 || argv == 0) {
+        fail("Cannot parse command: %s", app->command);
+        return 0;
+    }
     cmd = mprCreateCmd(0);
+    cmd->makeArgv = argv;
     if (eroute->searchPath) {
         mprSetCmdSearchPath(cmd, eroute->searchPath);
     }
     if (app->show) {
         trace("Run", app->command);
     }
-    /*  WARNING: GC will run here */
-    if (mprRunCmd(cmd, app->command, env, NULL, &out, &err, -1, 0) != 0) {
+    cmd->stdoutBuf = mprCreateBuf(ME_BUFSIZE, -1);
+    cmd->stderrBuf = mprCreateBuf(ME_BUFSIZE, -1);
+    mprAddNullToBuf(cmd->stdoutBuf);
+    mprAddNullToBuf(cmd->stderrBuf);
+    mprSetCmdCallback(cmd, commandCallback, NULL);
+    if (mprStartCmd(cmd, argc, argv, env, MPR_CMD_OUT | MPR_CMD_ERR) < 0) {
+        fail("Cannot run command: \n%s", app->command);
+        mprDestroyCmd(cmd);
+        return 0;
+    }
+    return cmd;
+}
+
+
+/*
+    Report the output of a completed command and destroy it
+ */
+static int finishEspCommand(MprCmd *cmd, cchar *command, cchar *csource)
+{
+    char    *err, *out;
+    int     status;
+
+    status = mprGetCmdExitStatus(cmd);
+    out = mprGetBufStart(cmd->stdoutBuf);
+    err = mprGetBufStart(cmd->stderrBuf);
+    if (status != 0) {
         if (err == 0 || *err == '\0') {
             /* Windows puts errors to stdout Ugh! */
             err = out;
         }
-        fail("Cannot run command: \n%s\nError: %s", app->command, err);
+        fail("Cannot run command: \n%s\nError: %s", command, err);
         mprDestroyCmd(cmd);
         return MPR_ERR_CANT_COMPLETE;
     }
@@ -1656,11 +1789,151 @@ static int runEspCommand(HttpRoute *route, cchar *command, cchar *csource, cchar
 }
 
 
+static int runEspCommand(HttpRoute *route, cchar *command, cchar *csource, cchar *module)
+{
+    MprCmd      *cmd;
+
+    if ((cmd = startEspCommand(route, command, csource, module)) == 0) {
+        return MPR_ERR_CANT_COMPLETE;
+    }
+    /*  WARNING: GC will run here */
+    if (mprWaitForCmd(cmd, -1) < 0) {
+        fail("Command did not complete: \n%s", app->command);
+        mprDestroyCmd(cmd);
+        return MPR_ERR_NOT_READY;
+    }
+    return finishEspCommand(cmd, app->command, csource);
+}
+
+
+/*
+    Queue a compile job for a source file. Jobs run concurrently up to the app->jobs limit.
+ */
+static void queueJob(HttpRoute *route, cchar *source, cchar *csource, cchar *module, int kind)
+{
+    EspJob      *job;
+
+    if ((job = mprAllocObj(EspJob, manageJob)) == 0) {
+        fail("Cannot allocate compile job");
+        return;
+    }
+    job->route = route;
+    job->source = source;
+    job->csource = csource;
+    job->module = module;
+    job->kind = kind;
+    job->object = app->combineObjects ? 1 : 0;
+    app->queued++;
+    if (!app->pending) {
+        app->pending = mprCreateList(0, MPR_LIST_STABLE);
+        app->running = mprCreateList(0, MPR_LIST_STABLE);
+    }
+    mprAddItem(app->pending, job);
+    runJobs(0);
+}
+
+
+static int startJob(EspJob *job, cchar *command)
+{
+    if ((job->cmd = startEspCommand(job->route, command, job->csource, job->module)) == 0) {
+        return MPR_ERR_CANT_COMPLETE;
+    }
+    job->command = app->command;
+    mprAddItem(app->running, job);
+    return 0;
+}
+
+
+/*
+    Start pending jobs and wait for jobs to complete. If "all" is set, wait until all jobs have completed.
+    Otherwise, return as soon as there is capacity to start another job. Pending jobs are not started after an error.
+    WARNING: GC will run here
+ */
+static void runJobs(bool all)
+{
+    EspRoute    *eroute;
+    EspJob      *job;
+    int         next;
+
+    if (!app->pending) {
+        return;
+    }
+    while (1) {
+        while (!app->error && mprGetListLength(app->pending) > 0 && mprGetListLength(app->running) < app->jobs) {
+            job = mprGetFirstItem(app->pending);
+            mprRemoveItemAtPos(app->pending, 0);
+            trace("Compile", "%s", mprGetRelPath(job->csource, 0));
+            eroute = job->route->eroute;
+            startJob(job, job->object ? eroute->objectCmd : eroute->compileCmd);
+        }
+        if (mprGetListLength(app->running) == 0 || (!all && mprGetListLength(app->running) < app->jobs)) {
+            break;
+        }
+        for (ITERATE_ITEMS(app->running, job, next)) {
+            if (mprIsCmdComplete(job->cmd)) {
+                break;
+            }
+        }
+        if (job) {
+            mprRemoveItem(app->running, job);
+            completeJob(job);
+        } else {
+            job = mprGetFirstItem(app->running);
+            mprWaitForCmd(job->cmd, 10);
+        }
+    }
+    if (all) {
+        mprClearList(app->pending);
+    }
+}
+
+
+/*
+    Complete a job command. Start the link command if required, otherwise record the module in the build manifest
+    and clean up intermediate files.
+ */
+static void completeJob(EspJob *job)
+{
+    EspRoute    *eroute;
+    MprCmd      *cmd;
+    cchar       *layout, *layoutsDir;
+
+    eroute = job->route->eroute;
+    cmd = job->cmd;
+    job->cmd = 0;
+    if (finishEspCommand(cmd, job->command, job->csource) < 0) {
+        return;
+    }
+    if (!job->linking && !job->object && eroute->linkCmd) {
+        vtrace("Link", "%s", mprGetRelPath(mprTrimPathExt(job->module), NULL));
+        job->linking = 1;
+        startJob(job, eroute->linkCmd);
+        return;
+    }
+#if !(ME_DEBUG && MACOSX)
+    if (job->linking) {
+        /*
+            MAC needs the object for debug information
+         */
+        mprDeletePath(mprJoinPathExt(mprTrimPathExt(job->module), ME_OBJ));
+    }
+#endif
+    layout = 0;
+    if ((job->kind & (ESP_VIEW | ESP_PAGE)) && (layoutsDir = httpGetDir(job->route, "LAYOUTS")) != 0) {
+        layout = mprJoinPath(layoutsDir, "default.esp");
+    }
+    espRecordModule(job->route, job->source, job->csource, job->module, layout, job->object ? "object" : NULL);
+    if (!eroute->keep && !app->keep && (job->kind & (ESP_VIEW | ESP_PAGE))) {
+        mprDeletePath(job->csource);
+    }
+}
+
+
 static void compileFile(HttpRoute *route, cchar *source, int kind)
 {
     EspRoute    *eroute;
-    cchar       *canonical, *defaultLayout, *page, *layout, *data, *prefix, *lpath, *appName, *cacheDir, *layoutsDir;
-    char        *err, *quote, *script;
+    cchar       *canonical, *defaultLayout, *page, *data, *prefix, *appName, *cacheDir, *layoutsDir;
+    char        *err, *script;
     ssize       len;
     int         recompile;
 
@@ -1688,7 +1961,14 @@ static void compileFile(HttpRoute *route, cchar *source, int kind)
     canonical = mprGetPortablePath(mprGetRelPath(source, route->home));
     appName = eroute->appName ? eroute->appName : route->host->name;
     app->cacheName = mprGetMD5WithPrefix(sfmt("%s:%s", appName, canonical), -1, prefix);
-    app->module = mprNormalizePath(sfmt("%s/%s%s", cacheDir, app->cacheName, ME_SHOBJ));
+    if (app->combineObjects) {
+        /* Incremental combine mode compiles each source to an object that is linked into the combined module */
+        app->module = mprNormalizePath(sfmt("%s/%s%s", cacheDir, app->cacheName, ME_OBJ));
+        addCombineItem(route, source, kind);
+        mprAddItem(app->combineObjects, app->module);
+    } else {
+        app->module = mprNormalizePath(sfmt("%s/%s%s", cacheDir, app->cacheName, ME_SHOBJ));
+    }
     if ((layoutsDir = httpGetDir(route, "LAYOUTS")) != 0) {
         defaultLayout = mprJoinPath(layoutsDir, "default.esp");
     } else {
@@ -1696,32 +1976,14 @@ static void compileFile(HttpRoute *route, cchar *source, int kind)
     }
     mprMakeDir(cacheDir, 0755, -1, -1, 1);
 
-    if (app->combine) {
+    if (app->combine && !app->combineObjects) {
         why(source, "\"combine\" mode requires complete rebuild");
 
     } else if (app->rebuild) {
         why(source, "due to requested rebuild");
 
     } else if (!espModuleIsStale(route, source, app->module, &recompile)) {
-        if (kind & (ESP_PAGE | ESP_VIEW)) {
-            if ((data = mprReadPathContents(source, &len)) == 0) {
-                fail("Cannot read %s", source);
-                return;
-            }
-            if ((lpath = scontains(data, "@ layout \"")) != 0) {
-                lpath = strim(&lpath[10], " ", MPR_TRIM_BOTH);
-                if ((quote = schr(lpath, '"')) != 0) {
-                    *quote = '\0';
-                }
-                layout = (layoutsDir && *lpath) ? mprJoinPath(layoutsDir, lpath) : 0;
-            } else {
-                layout = defaultLayout;
-            }
-            if (!layout || !espModuleIsStale(route, layout, app->module, &recompile)) {
-                why(source, "is up to date");
-                return;
-            }
-        } else {
+        if (!(kind & (ESP_PAGE | ESP_VIEW)) || !espLayoutIsStale(route, source, app->module)) {
             why(source, "is up to date");
             return;
         }
@@ -1746,14 +2008,7 @@ static void compileFile(HttpRoute *route, cchar *source, int kind)
                 return;
             }
             mprWriteFileFmt(app->combineFile, "\n\n");
-            if (kind & ESP_SRC) {
-                mprAddItem(app->combineItems, sfmt("esp_app_%s", eroute->appName));
-            } else if (eroute->appName && *eroute->appName) {
-                mprAddItem(app->combineItems,
-                    sfmt("esp_controller_%s_%s", eroute->appName, mprTrimPathExt(mprGetPathBase(source))));
-            } else {
-                mprAddItem(app->combineItems, sfmt("esp_controller_%s", mprTrimPathExt(mprGetPathBase(source))));
-            }
+            addCombineItem(route, source, kind);
         }
     }
     if (kind & (ESP_PAGE | ESP_VIEW)) {
@@ -1773,7 +2028,7 @@ static void compileFile(HttpRoute *route, cchar *source, int kind)
                 return;
             }
             mprWriteFileFmt(app->combineFile, "\n\n");
-            mprAddItem(app->combineItems, sfmt("esp_%s", app->cacheName));
+            addCombineItem(route, source, kind);
 
         } else {
             app->csource = mprJoinPathExt(mprTrimPathExt(app->module), ".c");
@@ -1786,32 +2041,14 @@ static void compileFile(HttpRoute *route, cchar *source, int kind)
         }
     }
     if (!app->combineFile) {
-        /*
-            WARNING: GC yield here
-         */
-        trace("Compile", "%s", mprGetRelPath(app->csource, 0));
         if (!eroute->compileCmd) {
             fail("Missing EspCompile directive for %s", app->csource);
             return;
         }
-        if (runEspCommand(route, eroute->compileCmd, app->csource, app->module) < 0) {
-            return;
-        }
-        if (eroute->linkCmd) {
-            vtrace("Link", "%s", mprGetRelPath(mprTrimPathExt(app->module), NULL));
-            if (runEspCommand(route, eroute->linkCmd, app->csource, app->module) < 0) {
-                return;
-            }
-#if !(ME_DEBUG && MACOSX)
-            /*
-                MAC needs the object for debug information
-             */
-            mprDeletePath(mprJoinPathExt(mprTrimPathExt(app->module), ME_OBJ));
-#endif
-        }
-        if (!eroute->keep && !app->keep && (kind & (ESP_VIEW | ESP_PAGE))) {
-            mprDeletePath(app->csource);
-        }
+        /*
+            WARNING: GC yield here
+         */
+        queueJob(route, source, app->csource, app->module, kind);
     }
 }
 
@@ -1845,7 +2082,10 @@ static void compile(int argc, char **argv)
             compileItems(route);
         }
     }
+    runJobs(1);
     app->built = 0;
+    app->pending = 0;
+    app->running = 0;
 
     /*
         Check we have compiled all targets
@@ -2040,8 +2280,8 @@ static void compileCombined(HttpRoute *route)
     MprJson         *extensions, *ext, *source, *sourceList;
     MprList         *files;
     cchar           *controllers, *item, *name;
-    char            *path, *line;
-    int             next, kind, index;
+    char            *path;
+    int             next, index;
 
     eroute = route->eroute;
     name = app->name ? app->name : mprGetPathBase(route->documents);
@@ -2051,6 +2291,7 @@ static void compileCombined(HttpRoute *route)
         Combined ... Catenate all source
      */
     app->combineItems = mprCreateList(-1, MPR_LIST_STABLE);
+    app->combineViews = mprCreateHash(0, MPR_HASH_STABLE);
     app->combinePath = mprJoinPath(httpGetDir(route, "CACHE"), sjoin(name, ".c", NULL));
 
     if ((sourceList = mprGetJsonObj(app->config, "esp.app.source")) != 0) {
@@ -2097,52 +2338,234 @@ static void compileCombined(HttpRoute *route)
     }
     if (mprGetHashLength(app->build) > 0) {
         mprMakeDir(httpGetDir(route, "CACHE"), 0755, -1, -1, 1);
-        if ((app->combineFile = mprOpenFile(app->combinePath, O_WRONLY | O_TRUNC | O_CREAT | O_BINARY, 0664)) == 0) {
-            fail("Cannot open %s", app->combinePath);
-            return;
-        }
-        mprWriteFileFmt(app->combineFile, "/*\n    Combined compilation of %s\n */\n\n", name);
-        mprWriteFileFmt(app->combineFile, "#include \"esp.h\"\n\n");
+        if (eroute->objectCmd && eroute->combineCmd) {
+            compileObjects(route, name);
+        } else {
+            if ((app->combineFile = mprOpenFile(app->combinePath, O_WRONLY | O_TRUNC | O_CREAT | O_BINARY, 0664)) == 0) {
+                fail("Cannot open %s", app->combinePath);
+                return;
+            }
+            mprWriteFileFmt(app->combineFile, "/*\n    Combined compilation of %s\n */\n\n", name);
+            mprWriteFileFmt(app->combineFile, "#include \"esp.h\"\n\n");
 
-        for (ITERATE_KEY_DATA(app->build, kp, item)) {
-            if (smatch(item, "src")) {
-                kind = ESP_SRC;
-            } else if (smatch(item, "controller")) {
-                kind = ESP_CONTROlLER;
-            } else if (smatch(item, "page")) {
-                kind = ESP_VIEW;
-            } else {
-                kind = ESP_PAGE;
+            for (ITERATE_KEY_DATA(app->build, kp, item)) {
+                compileFile(route, kp->key, getBuildKind(item));
             }
-            compileFile(route, kp->key, kind);
-        }
-        mprWriteFileFmt(app->combineFile,
-            "\nESP_EXPORT int esp_app_%s_combine(HttpRoute *route) {\n", name);
-        for (next = 0; (line = mprGetNextItem(app->combineItems, &next)) != 0; ) {
-            mprWriteFileFmt(app->combineFile, "    %s(route);\n", line);
-        }
-        mprWriteFileFmt(app->combineFile, "    return 0;\n}\n");
-        mprCloseFile(app->combineFile);
+            mprWriteFileFmt(app->combineFile, "%s", getCombineEntry(name, 0));
+            mprCloseFile(app->combineFile);
 
-        app->module = mprNormalizePath(sfmt("%s/%s%s", httpGetDir(route, "CACHE"), name, ME_SHOBJ));
-        trace("Compile", "%s", name);
-        if (runEspCommand(route, eroute->compileCmd, app->combinePath, app->module) < 0) {
-            return;
-        }
-        if (eroute->linkCmd) {
-            trace("Link", "%s", mprGetRelPath(mprTrimPathExt(app->module), NULL));
-            if (runEspCommand(route, eroute->linkCmd, app->combinePath, app->module) < 0) {
+            app->module = mprNormalizePath(sfmt("%s/%s%s", httpGetDir(route, "CACHE"), name, ME_SHOBJ));
+            trace("Compile", "%s", name);
+            if (runEspCommand(route, eroute->compileCmd, app->combinePath, app->module) < 0) {
                 return;
             }
+            if (eroute->linkCmd) {
+                trace("Link", "%s", mprGetRelPath(mprTrimPathExt(app->module), NULL));
+                if (runEspCommand(route, eroute->linkCmd, app->combinePath, app->module) < 0) {
+                    return;
+                }
+            }
         }
     }
     app->combineItems = 0;
+    app->combineObjects = 0;
+    app->combineViews = 0;
     app->combineFile = 0;
     app->combinePath = 0;
     app->build = 0;
 }
 
 
+/*
+    Compile each item of a combined app to its own cached object and link the objects into the combined module.
+    Objects are only rebuilt if their sources have changed. The module entry point and view table are generated
+    into a small main source that declares the separately compiled items.
+ */
+static void compileObjects(HttpRoute *route, cchar *name)
+{
+    EspRoute    *eroute;
+    MprKey      *kp;
+    MprPath     info, minfo;
+    cchar       *command, *data, *entry, *item, *object, *objects;
+    int         next, queued, recompile, stale;
+
+    eroute = route->eroute;
+    app->combineObjects = mprCreateList(-1, MPR_LIST_STABLE);
+    queued = app->queued;
+    for (ITERATE_KEY_DATA(app->build, kp, item)) {
+        compileFile(route, kp->key, getBuildKind(item));
+    }
+    /* WARNING: GC will run here */
+    runJobs(1);
+    if (app->error) {
+        return;
+    }
+    entry = sfmt("/*\n    Combined module entry for %s\n */\n%s", name, getCombineEntry(name, 1));
+    object = mprNormalizePath(sfmt("%s/%s%s", httpGetDir(route, "CACHE"), name, ME_OBJ));
+    app->module = mprNormalizePath(sfmt("%s/%s%s", httpGetDir(route, "CACHE"), name, ME_SHOBJ));
+
+    /*
+        The combined module is current if no objects were compiled, the entry source and combine command are
+        unchanged and no object is newer than the module
+     */
+    stale = app->rebuild || app->queued != queued;
+    mprGetPathInfo(app->module, &minfo);
+    if (!minfo.valid || (data = mprReadPathContents(app->combinePath, NULL)) == 0 || !smatch(data, entry)) {
+        stale = 1;
+    } else if (espModuleIsStale(route, app->combinePath, app->module, &recompile) && recompile) {
+        stale = 1;
+    }
+    objects = object;
+    for (ITERATE_ITEMS(app->combineObjects, item, next)) {
+        mprGetPathInfo(item, &info);
+        if (!info.valid || info.mtime > minfo.mtime) {
+            stale = 1;
+        }
+        objects = sjoin(objects, " ", item, NULL);
+    }
+    if (!stale) {
+        why(app->module, "is up to date");
+        return;
+    }
+    if (mprWritePathContents(app->combinePath, entry, slen(entry), 0664) < 0) {
+        fail("Cannot write %s", app->combinePath);
+        return;
+    }
+    trace("Compile", "%s", name);
+    if (runEspCommand(route, eroute->objectCmd, app->combinePath, object) < 0) {
+        return;
+    }
+    trace("Link", "%s", mprGetRelPath(mprTrimPathExt(app->module), NULL));
+    command = sreplace(eroute->combineCmd, "${OBJS}", objects);
+    if (runEspCommand(route, command, app->combinePath, app->module) < 0) {
+        return;
+    }
+    espRecordModule(route, app->combinePath, app->combinePath, app->module, NULL, "combine");
+}
+
+
+/*
+    Map an app->build item type to a compile kind
+ */
+static int getBuildKind(cchar *item)
+{
+    if (smatch(item, "src")) {
+        return ESP_SRC;
+    } else if (smatch(item, "controller")) {
+        return ESP_CONTROlLER;
+    } else if (smatch(item, "page")) {
+        return ESP_VIEW;
+    }
+    return ESP_PAGE;
+}
+
+
+/*
+    Register an item to be initialized by the combined module entry point
+ */
+static void addCombineItem(HttpRoute *route, cchar *source, int kind)
+{
+    EspRoute    *eroute;
+
+    eroute = route->eroute;
+    if (kind & (ESP_PAGE | ESP_VIEW)) {
+        mprAddKey(app->combineViews, mprGetPortablePath(mprGetRelPath(source, route->documents)), app->cacheName);
+    } else if (kind & ESP_SRC) {
+        mprAddItem(app->combineItems, sfmt("esp_app_%s", eroute->appName));
+    } else if (eroute->appName && *eroute->appName) {
+        mprAddItem(app->combineItems,
+            sfmt("esp_controller_%s_%s", eroute->appName, mprTrimPathExt(mprGetPathBase(source))));
+    } else {
+        mprAddItem(app->combineItems, sfmt("esp_controller_%s", mprTrimPathExt(mprGetPathBase(source))));
+    }
+}
+
+
+/*
+    Generate the combined module entry point and view table. If "declare" is set, the items are compiled separately
+    and are declared before use.
+ */
+static char *getCombineEntry(cchar *name, bool declare)
+{
+    MprBuf      *buf;
+    MprKey      *kp;
+    cchar       *item;
+    bool        viewTable;
+    int         next;
+
+    buf = mprCreateBuf(0, 0);
+    if (declare) {
+        mprPutStringToBuf(buf, "#include \"esp.h\"\n\n");
+        for (ITERATE_ITEMS(app->combineItems, item, next)) {
+            mprPutToBuf(buf, "extern int %s(HttpRoute *route);\n", item);
+        }
+        for (ITERATE_KEY_DATA(app->combineViews, kp, item)) {
+            mprPutToBuf(buf, "extern int esp_%s(HttpRoute *route);\n", item);
+            mprPutToBuf(buf, "extern void %s(HttpStream *stream);\n", item);
+        }
+        mprPutCharToBuf(buf, '\n');
+    }
+    viewTable = writeViewTable(buf);
+    mprPutToBuf(buf, "\nESP_EXPORT int esp_app_%s_combine(HttpRoute *route) {\n", name);
+    for (ITERATE_ITEMS(app->combineItems, item, next)) {
+        mprPutToBuf(buf, "    %s(route);\n", item);
+    }
+    if (viewTable) {
+        mprPutStringToBuf(buf, "    espDefineViews(route, &esp_views);\n");
+    } else {
+        for (ITERATE_KEY_DATA(app->combineViews, kp, item)) {
+            mprPutToBuf(buf, "    esp_%s(route);\n", item);
+        }
+    }
+    mprPutStringToBuf(buf, "    return 0;\n}\n");
+    mprAddNullToBuf(buf);
+    return mprGetBufStart(buf);
+}
+
+
+/*
+    Write a static perfect hash table of the combined views so views are not registered individually at startup.
+    Returns false if there are no views or the table cannot be computed.
+ */
+static bool writeViewTable(MprBuf *buf)
+{
+    MprKey      *kp;
+    cchar       **keys, **ordered;
+    int         *seeds, *slots, count, i;
+
+    if ((count = mprGetHashLength(app->combineViews)) == 0) {
+        return 0;
+    }
+    keys = mprAlloc(count * sizeof(cchar*));
+    ordered = mprAllocZeroed(count * sizeof(cchar*));
+    seeds = mprAlloc(count * sizeof(int));
+    slots = mprAlloc(count * sizeof(int));
+    i = 0;
+    for (ITERATE_KEYS(app->combineViews, kp)) {
+        keys[i++] = kp->key;
+    }
+    if (espComputePerfectHash(keys, count, seeds, slots) < 0) {
+        trace("Warn", "Cannot compute view table, using view registration");
+        return 0;
+    }
+    mprPutStringToBuf(buf, "/*\n    Perfect hash table of views\n */\n");
+    mprPutToBuf(buf, "static const int esp_views_seeds[%d] = {\n", count);
+    for (i = 0; i < count; i++) {
+        mprPutToBuf(buf, "    %d,\n", seeds[i]);
+    }
+    mprPutToBuf(buf, "};\n\nstatic const EspHashEntry esp_views_entries[%d] = {\n", count);
+    i = 0;
+    for (ITERATE_KEYS(app->combineViews, kp)) {
+        ordered[slots[i++]] = kp->key;
+    }
+    for (i = 0; i < count; i++) {
+        mprPutToBuf(buf, "    { \"%s\", (void*) %s },\n", ordered[i], (cchar*) mprLookupKey(app->combineViews, ordered[i]));
+    }
+    mprPutToBuf(buf, "};\n\nstatic const EspPerfectHash esp_views = { %d, esp_views_seeds, esp_views_entries };\n", count);
+    return 1;
+}
+
+
 static void generateItem(cchar *item)
 {
     if (getJson(app->config, sfmt("esp.generate.%s", item), 0) == 0) {
@@ -2636,6 +3059,7 @@ static void usageError()
     "    --dir DIR=path             # Set directory to path\n"
     "    --force                    # Force requested action\n"
     "    --home directory           # Change to directory first\n"
+    "    --jobs N                   # Run N compile jobs in parallel. Defaults to the CPU core count\n"
     "    --keep                     # Keep intermediate source\n"
     "    --listen [ip:]port         # Generate app to listen at address\n"
     "    --log logFile:level        # Log to file at verbosity level (0-5)\n"
@@ -26,11 +26,25 @@ extern "C" {
 #ifndef ME_ESP_RELOAD_TIMEOUT
     #define ME_ESP_RELOAD_TIMEOUT (5 * 1000)            /**< Timeout for reloading esp modules */
 #endif
+#ifndef ME_ESP_FRAGMENT_MEMORY
+    #define ME_ESP_FRAGMENT_MEMORY (16 * 1024 * 1024)  /**< Maximum memory for cached view fragments */
+#endif
+#ifndef ME_ESP_PERFECT_HASH_TRIES
+    #define ME_ESP_PERFECT_HASH_TRIES (1024 * 1024)     /**< Maximum seeds to try per bucket when building perfect hashes */
+#endif
+#ifndef ME_ESP_NOTIFY
+    #if LINUX
+        #define ME_ESP_NOTIFY 1                         /**< Use inotify to detect updated sources */
+    #else
+        #define ME_ESP_NOTIFY 0
+    #endif
+#endif
 #define ESP_TOK_INCR        1024                        /**< Growth increment for ESP tokens */
 #define ESP_LISTEN          "4000"                      /**< Default listening endpoint for the esp program */
 #define ESP_UNLOAD_TIMEOUT  (10)                        /**< Very short timeout for reloading */
 #define ESP_LIFESPAN        (3600 * TPS)                /**< Default generated content cache lifespan */
 #define ESP_COMPILE_JSON    "esp-compile.json"          /**< Compile rules filename */
+#define ESP_MANIFEST        "manifest.json"             /**< Build manifest filename in the cache directory */
 
 #if ME_64
     #define ESP_VSKEY "HKLM\\SOFTWARE\\Wow6432Node\\Microsoft\\VisualStudio\\SxS\\VS7"
@@ -107,6 +121,7 @@ typedef struct EspState {
     MprBuf  *global;                        /**< Accumulated compiled esp global code */
     MprBuf  *start;                         /**< Accumulated compiled esp start of function code */
     MprBuf  *end;                           /**< Accumulated compiled esp end of function code */
+    int     fragments;                      /**< Depth of open fragment directives */
 } EspState;
 
 #define ESP_COMPILE_SYMBOLS     0           /**< Override to compile in debug mode. Defaults to same as Appweb */
@@ -119,6 +134,14 @@ typedef struct Esp {
     MprHash         *databases;             /**< Cloned databases */
     MprEvent        *databasesTimer;        /**< Database prune timer */
     MprHash         *internalOptions;       /**< Table of internal HTML control options  */
+    MprHash         *manifests;             /**< Loaded build manifests indexed by path */
+    MprHash         *checked;               /**< Time of last module update check indexed by source */
+    MprCache        *fragments;             /**< Cache of rendered view fragments */
+#if ME_ESP_NOTIFY
+    MprHash         *watches;               /**< Directories watched for updates */
+    MprWaitHandler  *notifyHandler;         /**< Wait handler for update notifications */
+    int             notifyFd;               /**< Inotify file descriptor */
+#endif
     MprThreadLocal  *local;                 /**< Thread local data */
     MprMutex        *mutex;                 /**< Multithread lock */
     EdiService      *ediService;            /**< Database service */
@@ -172,6 +195,65 @@ PUBLIC void espInitHtmlOptions(Esp *esp);
  */
 PUBLIC int espInitParser(void);
 
+/**
+    Perfect hash table entry
+    @ingroup EspRoute
+    @stability Prototype
+ */
+typedef struct EspHashEntry {
+    cchar       *key;                       /**< View path or action target */
+    void        *value;                     /**< View procedure or EspAction */
+} EspHashEntry;
+
+/**
+    Perfect hash table
+    @description Perfect hash tables map a fixed set of keys to values with one hash computation and one key
+        comparison per lookup. Combined applications generate a static table of their views at build time.
+        Keys are assigned to buckets by hash. Each bucket has a seed that maps its keys to distinct entries.
+    @ingroup EspRoute
+    @stability Prototype
+ */
+typedef struct EspPerfectHash {
+    int                 size;               /**< Number of buckets and entries */
+    const int           *seeds;             /**< Per-bucket hash seeds selecting the entry for keys in the bucket */
+    const EspHashEntry  *entries;           /**< Entries indexed by hash slot */
+} EspPerfectHash;
+
+/**
+    Compute the seeds and slots of a perfect hash table
+    @description The keys are hashed into "count" buckets and a seed is computed for each bucket so that every key
+        maps to a distinct slot. This is used by the esp utility when generating combined applications.
+    @param keys Array of unique keys
+    @param count Number of keys
+    @param seeds Array of "count" integers to receive the bucket seeds
+    @param slots Array of "count" integers to receive the slot for each key
+    @return Zero if successful, otherwise a negative MPR error code.
+    @ingroup EspRoute
+    @stability Prototype
+    @internal
+ */
+PUBLIC int espComputePerfectHash(cchar **keys, int count, int *seeds, int *slots);
+
+/**
+    Create a perfect hash table from a hash
+    @param hash Hash table. The table key and data are used as the perfect hash key and value.
+    @return A perfect hash table or null if it cannot be created.
+    @ingroup EspRoute
+    @stability Prototype
+    @internal
+ */
+PUBLIC EspPerfectHash *espCreatePerfectHash(MprHash *hash);
+
+/**
+    Lookup a key in a perfect hash table
+    @param table Perfect hash table
+    @param key Key to find
+    @return The value for the key or null if the key is not present.
+    @ingroup EspRoute
+    @stability Prototype
+ */
+PUBLIC void *espLookupPerfectHash(const EspPerfectHash *table, cchar *key);
+
 /********************************** EspRoutes *********************************/
 /**
     EspRoute extended route configuration.
@@ -185,15 +267,20 @@ typedef struct EspRoute {
     HttpRoute       *route;                 /**< Back link to route */
     EspProc         commonController;       /**< Common code for all controllers */
     MprTime         loaded;                 /**< When configuration was last loaded */
+    MprTicks        updateInterval;         /**< Minimum period between checks of a module for updates */
 
     MprHash         *actions;               /**< Table of actions */
     MprHash         *env;                   /**< Environment variables for route */
     MprHash         *views;                 /**< Table of views */
+    EspPerfectHash  *actionTable;           /**< Perfect hash of actions for combined apps */
+    const EspPerfectHash *viewTable;        /**< Static perfect hash of views for combined apps (not managed) */
     cchar           *currentSession;        /**< Current login session when enforcing a single login */
     cchar           *configFile;            /**< Path to config file */
 
     cchar           *compileCmd;            /**< Compile command template */
     cchar           *linkCmd;               /**< Link command template */
+    cchar           *objectCmd;             /**< Compile command template for objects of a combined app */
+    cchar           *combineCmd;            /**< Link command template to link objects into a combined app */
     cchar           *searchPath;            /**< Search path to use when locating compiler/linker */
     cchar           *winsdk;                /**< Windows SDK */
 
@@ -202,6 +289,7 @@ typedef struct EspRoute {
     uint            compileMode: 1;         /**< Compile the application debug or release mode */
     uint            compile: 1;             /**< Enable recompiling the application or esp page */
     uint            encodeTypes: 1;         /**< Encode data types in JSON API request/response */
+    uint            inProcess: 1;           /**< Compile views in-process with the embedded compiler (libtcc) */
     uint            keep: 1;                /**< Keep intermediate source code after compiling */
     uint            update: 1;              /**< Enable dynamically updating the application */
 
@@ -371,6 +459,23 @@ PUBLIC int espCache(HttpRoute *route, cchar *uri, int lifesecs, int flags);
 PUBLIC bool espCompile(HttpRoute *route, MprDispatcher *dispatcher, cchar *source, cchar *module, cchar *cacheName,
     int isView, char **errMsg);
 
+/**
+    Compile and load an ESP view in-process
+    @description This compiles an ESP view into memory using the embedded compiler (libtcc) and loads it without
+        writing or linking a shared library. The view is registered via its module entry point in the same manner
+        as views loaded from modules. Only available if ESP is built with the "tcc" component.
+    @param route HttpRoute object
+    @param source ESP source file name
+    @param module Module file name. This is used to record the build in the cache manifest.
+    @param cacheName MD5 cache name. Not a full path
+    @param errMsg Reference to receive an error message if the routine fails.
+    @return "True" if the compilation is successful.
+    @ingroup EspRoute
+    @stability Prototype
+    @internal
+ */
+PUBLIC bool espCompileInProcess(HttpRoute *route, cchar *source, cchar *module, cchar *cacheName, char **errMsg);
+
 /**
     Convert an ESP web page into C code
     @description This parses an ESP web page into an equivalent C source view.
@@ -446,6 +551,17 @@ PUBLIC void espDefineBase(HttpRoute *route, EspLegacyProc baseProc) ME_DEPRECATE
  */
 PUBLIC void espDefineView(HttpRoute *route, cchar *path, void *viewProc);
 
+/**
+    Define a static table of views
+    @description Combined applications generate a static perfect hash table of their views. Views in the table are
+        used in preference to views defined via #espDefineView.
+    @param route Http route object
+    @param views Static perfect hash table of view paths and view procedures. The table is not copied.
+    @ingroup EspRoute
+    @stability Prototype
+ */
+PUBLIC void espDefineViews(HttpRoute *route, const EspPerfectHash *views);
+
 /**
     Expand a compile or link command template
     @description This expands a command template and replaces "${tokens}" with their equivalent value. The supported
@@ -560,7 +676,10 @@ PUBLIC bool espTestConfig(HttpRoute *route, cchar *key, cchar *desired);
  */
 PUBLIC cchar *espGetVisualStudio(void);
 PUBLIC void espManageEspRoute(EspRoute *eroute, int flags);
+PUBLIC bool espLayoutIsStale(HttpRoute *route, cchar *source, cchar *module);
 PUBLIC bool espModuleIsStale(HttpRoute *route, cchar *source, cchar *module, int *recompile);
+PUBLIC void espRecordModule(HttpRoute *route, cchar *source, cchar *csource, cchar *module, cchar *layout,
+    cchar *rule);
 PUBLIC int espOpenDatabase(HttpRoute *route, cchar *spec);
 PUBLIC void espCloseDatabase(HttpRoute *route);
 PUBLIC int espReloadDatabase(HttpRoute *route);
@@ -594,6 +713,8 @@ typedef struct EspReq {
     int             sessionProbed;          /**< Already probed for session store */
     int             lastDomID;              /**< Last generated DOM ID */
     Edi             *edi;                   /**< Database for this request */
+    MprList         *fragments;             /**< Stack of view fragments being captured */
+    int             serviced;               /**< Count of write queue services that may have flushed output */
 } EspReq;
 
 /**
@@ -667,6 +788,36 @@ PUBLIC void espAppendHeaderString(HttpStream *stream, cchar *key, cchar *value);
  */
 PUBLIC void espAutoFinalize(HttpStream *stream);
 
+/**
+    Begin rendering a cacheable view fragment
+    @description If the fragment is in the cache, the cached content is rendered and this call returns false.
+        Otherwise, subsequent output is captured until #espEndFragment is called and then saved in the cache.
+        This is used by the template "fragment" directive. Fragments may be nested. Fragment keys should include
+        the application data that determines the content, such as a record ID and its last updated time.
+        Captured output is held in the write queue until #espEndFragment. If the write queue is flushed during
+        capture, the fragment is rendered without caching. Beginning a fragment enables queueing of output in the
+        write queue for the rest of the request.
+    @param stream HttpStream stream object
+    @param key Cache key for the fragment. If null, the fragment is rendered without caching.
+    @param lifespan Lifespan of the cached fragment in milliseconds. Set to zero for the default lifespan.
+    @return True if the caller must render the fragment and then call #espEndFragment.
+    @ingroup EspReq
+    @stability Prototype
+    @see espEndFragment espRenderFragment
+ */
+PUBLIC bool espBeginFragment(HttpStream *stream, cchar *key, MprTicks lifespan);
+
+/**
+    Close fragments that were not ended
+    @description Discard fragments opened above the given depth without caching them and restore the write queue
+        limit. This is called when a view completes and when the request is closed.
+    @param stream HttpStream stream object
+    @param depth Number of enclosing fragments to preserve
+    @ingroup EspReq
+    @internal
+ */
+PUBLIC void espCloseFragments(HttpStream *stream, int depth);
+
 /**
     Create a session state object.
     @description The session state object can be used to share state between requests.
@@ -706,6 +857,16 @@ PUBLIC void espDestroySession(HttpStream *stream);
 PUBLIC int espEmail(HttpStream *stream, cchar *to, cchar *from, cchar *subject, MprTime date, cchar *mime,
     cchar *message, MprList *files);
 
+/**
+    End rendering a cacheable view fragment
+    @description Save the output rendered since the matching #espBeginFragment call in the fragment cache.
+    @param stream HttpStream stream object
+    @ingroup EspReq
+    @stability Prototype
+    @see espBeginFragment espRenderFragment
+ */
+PUBLIC void espEndFragment(HttpStream *stream);
+
 /**
     Indicate the request is finalized.
     @description Calling this routine indicates that the handler has fully finished processing the request including
@@ -1294,6 +1455,20 @@ PUBLIC ssize espRenderFeedback(HttpStream *stream, cchar *types);
  */
 PUBLIC ssize espRenderFile(HttpStream *stream, cchar *path);
 
+/**
+    Render a cacheable view fragment
+    @description Render cached fragment content if present. Otherwise invoke the proc to render the fragment and
+        save the output in the fragment cache.
+    @param stream HttpStream stream object
+    @param key Cache key for the fragment. If null, the fragment is rendered without caching.
+    @param lifespan Lifespan of the cached fragment in milliseconds. Set to zero for the default lifespan.
+    @param proc View procedure to render the fragment
+    @ingroup EspReq
+    @stability Prototype
+    @see espBeginFragment espEndFragment
+ */
+PUBLIC void espRenderFragment(HttpStream *stream, cchar *key, MprTicks lifespan, EspViewProc proc);
+
 /**
     Read a table from the current database
     @param stream HttpStream stream object
@@ -1330,6 +1505,20 @@ PUBLIC ssize espRenderSafe(HttpStream *stream, cchar *fmt, ...);
  */
 PUBLIC ssize espRenderSafeString(HttpStream *stream, cchar *s);
 
+/**
+    Render a block of static data to the client
+    @description Render static, read-only data such as the literal text of a compiled ESP page. Large blocks are
+        queued by reference without copying. The data must remain valid until the request completes. This is used
+        by compiled ESP pages.
+    @param stream HttpStream stream object
+    @param buf Static data to write
+    @param size Size of the data in buf
+    @return A count of the bytes actually written
+    @ingroup EspReq
+    @stability Prototype
+ */
+PUBLIC ssize espRenderStatic(HttpStream *stream, cchar *buf, ssize size);
+
 /**
     Render a string of data to the client
     @description Render a string of data to the client. Data packets will be created
@@ -1378,6 +1567,21 @@ PUBLIC bool espRenderView(HttpStream *stream, cchar *view, int flags);
   */
 PUBLIC ssize espSendGrid(HttpStream *stream, EdiGrid *grid, int flags);
 
+/**
+    Send the records from a database cursor as a JSON string
+    @description The records are rendered as they are read from the cursor as part of an enclosing "{ data: JSON }"
+        wrapper. This avoids reading the entire result into memory. The cursor is closed when all records have been sent.
+        As with #espSendGrid, the "count" property is the total count of available records matching the query.
+        This routine may block and yield while the response is written to the client.
+    @param stream HttpStream stream object
+    @param cursor EDI cursor returned from ediOpenCursor
+    @param flags Reserved. Set to zero.
+    @return Number of bytes rendered
+    @ingroup EspReq
+    @stability Prototype
+  */
+PUBLIC ssize espSendCursor(HttpStream *stream, EdiCursor *cursor, int flags);
+
 /**
     Send a database record as a JSON string
     @description The JSON string is rendered as part of an enclosing "{ data: JSON }" wrapper.
@@ -2759,6 +2963,17 @@ PUBLIC int runCmd(cchar *command, char *input, char **output, char **error, MprT
 PUBLIC void scripts(cchar *patterns);
 #endif
 
+/**
+    Send the records from a database cursor as a JSON string to the request client
+    @description The records are streamed as they are read from the cursor as part of an enclosing
+    "{ data: JSON, schema: schema }" wrapper. Use this instead of sendGrid for large results. The cursor is closed.
+    @param cursor EDI cursor returned from ediOpenCursor
+    @return Number of bytes sent
+    @ingroup EspReq
+    @stability Prototype
+  */
+PUBLIC ssize sendCursor(EdiCursor *cursor);
+
 /**
     Send a database grid as a JSON string to the request client
     @description The JSON string is rendered as part of an enclosing "{ data: JSON, schema: schema }" wrapper.
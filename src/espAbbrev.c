@@ -692,6 +692,12 @@ PUBLIC void securityToken()
 }
 
 
+PUBLIC ssize sendCursor(EdiCursor *cursor)
+{
+    return espSendCursor(getStream(), cursor, 0);
+}
+
+
 PUBLIC ssize sendGrid(EdiGrid *grid)
 {
     return espSendGrid(getStream(), grid, 0);
@@ -162,6 +162,24 @@ static void parseCompile(HttpRoute *route, cchar *key, MprJson *prop)
 }
 
 
+/*
+    esp.compiler: "tcc" to compile views in-process with the embedded compiler. Otherwise "external" (default).
+ */
+static void parseCompiler(HttpRoute *route, cchar *key, MprJson *prop)
+{
+    EspRoute    *eroute;
+
+    eroute = route->eroute;
+    eroute->inProcess = smatch(prop->value, "tcc") ? 1 : 0;
+#if !ME_COM_TCC
+    if (eroute->inProcess) {
+        mprLog("warn esp", 0, "ESP not built with the embedded compiler (tcc), using the external compiler");
+        eroute->inProcess = 0;
+    }
+#endif
+}
+
+
 #if ME_WIN_LIKE
 PUBLIC cchar *espGetVisualStudio()
 {
@@ -335,6 +353,12 @@ static void parseBuild(HttpRoute *route, cchar *key, MprJson *prop)
         if ((rule = mprGetJson(route->config, sfmt("%s.%s", stem, "link"))) != 0) {
             eroute->linkCmd = rule;
         }
+        if ((rule = mprGetJson(route->config, sfmt("%s.%s", stem, "object"))) != 0) {
+            eroute->objectCmd = rule;
+        }
+        if ((rule = mprGetJson(route->config, sfmt("%s.%s", stem, "combine"))) != 0) {
+            eroute->combineCmd = rule;
+        }
         if ((env = mprGetJsonObj(route->config, sfmt("%s.%s", stem, "env"))) != 0) {
             if (eroute->env == 0) {
                 eroute->env = mprCreateHash(-1, MPR_HASH_STABLE);
@@ -377,6 +401,18 @@ static void parseUpdate(HttpRoute *route, cchar *key, MprJson *prop)
 }
 
 
+/*
+    esp.updateInterval: "5 secs". Use "never" to check only when notified of updates.
+ */
+static void parseUpdateInterval(HttpRoute *route, cchar *key, MprJson *prop)
+{
+    EspRoute    *eroute;
+
+    eroute = route->eroute;
+    eroute->updateInterval = httpGetTicks(prop->value);
+}
+
+
 static void serverRouteSet(HttpRoute *route, cchar *set)
 {
     httpAddRestfulRoute(route, "GET,POST", "/{action}(/)*$", "${action}", "{controller}");
@@ -422,9 +458,11 @@ PUBLIC int espInitParser()
     httpAddConfig("esp.build", parseBuild);
     httpAddConfig("esp.combine", parseCombine);
     httpAddConfig("esp.compile", parseCompile);
+    httpAddConfig("esp.compiler", parseCompiler);
     httpAddConfig("esp.keep", parseKeep);
     httpAddConfig("esp.optimize", parseOptimize);
     httpAddConfig("esp.update", parseUpdate);
+    httpAddConfig("esp.updateInterval", parseUpdateInterval);
     return 0;
 }
 
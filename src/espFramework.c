@@ -13,9 +13,25 @@
 #define ITERATE_CONFIG(route, obj, child, index) \
     index = 0, child = obj ? obj->children: 0; obj && index < obj->length && !route->error; child = child->next, index++
 
+/*
+    View fragment being captured
+ */
+typedef struct EspFragment {
+    cchar       *key;                       /* Cache key. Null if not caching */
+    HttpPacket  *mark;                      /* Last packet in the write queue when capture began. Null if empty */
+    ssize       offset;                     /* Length of the mark packet content when capture began */
+    ssize       max;                        /* Saved write queue maximum */
+    MprTicks    lifespan;                   /* Cache lifespan */
+    int         serviced;                   /* Write queue service count when capture began */
+} EspFragment;
+
 /*********************************** Fowards **********************************/
 
 static EspAction *createAction(cchar *target, cchar *abilities, void *callback);
+static uint hashKey(cchar *key, uint seed);
+static void manageFragment(EspFragment *fragment, int flags);
+static void outgoingFragmentService(HttpQueue *q);
+static void managePerfectHash(EspPerfectHash *table, int flags);
 
 /************************************* Code ***********************************/
 
@@ -101,6 +117,150 @@ PUBLIC void espAutoFinalize(HttpStream *stream)
 }
 
 
+/*
+    Render a cached fragment or mark the write queue to capture the fragment output.
+    Fragment keys are scoped by the application home directory.
+ */
+PUBLIC bool espBeginFragment(HttpStream *stream, cchar *key, MprTicks lifespan)
+{
+    EspReq      *req;
+    EspFragment *fragment;
+    HttpQueue   *q;
+    MprBuf      *content;
+
+    req = stream->reqData;
+    q = stream->writeq;
+    if (key) {
+        key = sfmt("%s::%s", req->route->home, key);
+        if (mprReadCache(req->esp->fragments, key, 0, 0) && (content = mprGetCacheLink(req->esp->fragments, key)) != 0) {
+            espRenderBlock(stream, mprGetBufStart(content), mprGetBufLength(content));
+            return 0;
+        }
+        if (!q->service) {
+            /*
+                Queue output in the write queue so it can be captured. The service remains for the rest of the
+                request so queued output is always forwarded in order.
+             */
+            q->service = outgoingFragmentService;
+        } else if (q->service != outgoingFragmentService) {
+            /* Cannot detect if the output is flushed during capture */
+            key = 0;
+        }
+    }
+    if ((fragment = mprAllocObj(EspFragment, manageFragment)) == 0) {
+        return 0;
+    }
+    fragment->key = key;
+    fragment->lifespan = lifespan;
+    fragment->mark = q->last;
+    fragment->offset = (q->last && q->last->content) ? mprGetBufLength(q->last->content) : 0;
+    fragment->max = q->max;
+    fragment->serviced = req->serviced;
+    if (key) {
+        /*
+            Hold the output in the write queue until the fragment is complete
+         */
+        q->max = MAXSSIZE;
+    }
+    if (!req->fragments) {
+        req->fragments = mprCreateList(0, 0);
+    }
+    mprPushItem(req->fragments, fragment);
+    return 1;
+}
+
+
+/*
+    Save the output written since the fragment began in the fragment cache
+ */
+PUBLIC void espEndFragment(HttpStream *stream)
+{
+    EspReq      *req;
+    EspFragment *fragment;
+    HttpPacket  *packet;
+    HttpQueue   *q;
+    MprBuf      *buf;
+    cchar       *start;
+    ssize       len;
+
+    req = stream->reqData;
+    q = stream->writeq;
+    if (!req->fragments || (fragment = mprPopItem(req->fragments)) == 0) {
+        return;
+    }
+    q->max = fragment->max;
+    if (!fragment->key || stream->error) {
+        return;
+    }
+    if (req->serviced != fragment->serviced) {
+        /* Output may have been flushed during capture */
+        return;
+    }
+    buf = mprCreateBuf(ME_BUFSIZE, -1);
+    for (packet = fragment->mark ? fragment->mark : q->first; packet; packet = packet->next) {
+        if (!(packet->flags & HTTP_PACKET_DATA) || !packet->content) {
+            continue;
+        }
+        start = mprGetBufStart(packet->content);
+        len = mprGetBufLength(packet->content);
+        if (packet == fragment->mark) {
+            start += fragment->offset;
+            len -= fragment->offset;
+        }
+        mprPutBlockToBuf(buf, start, len);
+    }
+    /*
+        The cache item data is the content length. The content is linked to the item so it may contain nulls.
+     */
+    if (mprWriteCache(req->esp->fragments, fragment->key, itos(mprGetBufLength(buf)), 0,
+            fragment->lifespan > 0 ? fragment->lifespan : ESP_LIFESPAN, 0, 0) > 0) {
+        mprWriteCacheLink(req->esp->fragments, fragment->key, buf, mprGetBufLength(buf));
+    }
+}
+
+
+/*
+    Discard fragments opened above the given depth that were not ended, and restore the write queue limit.
+    Called when a view completes and when the request is closed.
+ */
+PUBLIC void espCloseFragments(HttpStream *stream, int depth)
+{
+    EspReq      *req;
+    EspFragment *fragment;
+
+    if ((req = stream->reqData) == 0 || !req->fragments) {
+        return;
+    }
+    while (mprGetListLength(req->fragments) > depth && (fragment = mprPopItem(req->fragments)) != 0) {
+        stream->writeq->max = fragment->max;
+    }
+}
+
+
+static void manageFragment(EspFragment *fragment, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(fragment->key);
+        mprMark(fragment->mark);
+    }
+}
+
+
+/*
+    Write queue service installed by espBeginFragment. Count services that may forward queued output so
+    espEndFragment can detect if a fragment was flushed while being captured.
+ */
+static void outgoingFragmentService(HttpQueue *q)
+{
+    EspReq      *req;
+
+    if (q->first && (req = q->stream->reqData) != 0) {
+        req->serviced++;
+    }
+    httpDefaultService(q);
+}
+
+
 PUBLIC int espCache(HttpRoute *route, cchar *uri, int lifesecs, int flags)
 {
     httpAddCache(route, NULL, uri, NULL, NULL, 0, lifesecs * TPS, flags);
@@ -150,6 +310,8 @@ PUBLIC void espAction(HttpRoute *route, cchar *target, cchar *abilities, EspProc
         if (!eroute->actions) {
             eroute->actions = mprCreateHash(-1, 0);
         }
+        /* The action table references the actions hash and must be rebuilt if the hash is modified */
+        eroute->actionTable = 0;
         if ((action = createAction(target, abilities, callback)) == 0) {
             /* Memory errors centrally reported */
             return;
@@ -251,6 +413,179 @@ PUBLIC void espDefineView(HttpRoute *route, cchar *path, void *view)
 }
 
 
+/*
+    Define the static view table for a combined application
+ */
+PUBLIC void espDefineViews(HttpRoute *route, const EspPerfectHash *views)
+{
+    EspRoute    *eroute;
+
+    assert(views);
+
+    if ((eroute = route->eroute) == 0 && (eroute = espRoute(route, 1)) == 0) {
+        return;
+    }
+    eroute->top->viewTable = views;
+}
+
+
+/*
+    FNV-1a hash. Seed zero selects the bucket for a key and the bucket seed selects the slot.
+ */
+static uint hashKey(cchar *key, uint seed)
+{
+    uint    hash;
+
+    hash = 2166136261U ^ (seed * 16777619U);
+    for (; *key; key++) {
+        hash ^= (uchar) *key;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+/*
+    Compute a perfect hash via hash and displace. Keys are hashed into buckets and the buckets are processed in
+    order of decreasing size. For each bucket, a seed is found that maps all its keys to free slots.
+ */
+PUBLIC int espComputePerfectHash(cchar **keys, int count, int *seeds, int *slots)
+{
+    char    *used;
+    int     *buckets, *sizes, *start, *members;
+    int     b, i, j, k, n, size, maxSize, seed;
+
+    if (count <= 0) {
+        return 0;
+    }
+    buckets = mprAlloc(count * sizeof(int));
+    sizes = mprAllocZeroed(count * sizeof(int));
+    start = mprAlloc((count + 1) * sizeof(int));
+    members = mprAlloc(count * sizeof(int));
+    used = mprAllocZeroed(count);
+    if (!buckets || !sizes || !start || !members || !used) {
+        return MPR_ERR_MEMORY;
+    }
+    maxSize = 0;
+    for (i = 0; i < count; i++) {
+        buckets[i] = hashKey(keys[i], 0) % count;
+        sizes[buckets[i]]++;
+        maxSize = max(maxSize, sizes[buckets[i]]);
+    }
+    for (b = 0, start[0] = 0; b < count; b++) {
+        start[b + 1] = start[b] + sizes[b];
+        sizes[b] = 0;
+        seeds[b] = 0;
+    }
+    for (i = 0; i < count; i++) {
+        b = buckets[i];
+        members[start[b] + sizes[b]++] = i;
+    }
+    for (size = maxSize; size > 0; size--) {
+        for (b = 0; b < count; b++) {
+            if (sizes[b] != size) {
+                continue;
+            }
+            for (seed = 1; seed < ME_ESP_PERFECT_HASH_TRIES; seed++) {
+                for (n = 0; n < size; n++) {
+                    i = members[start[b] + n];
+                    slots[i] = hashKey(keys[i], seed) % count;
+                    if (used[slots[i]]) {
+                        break;
+                    }
+                    for (j = 0; j < n; j++) {
+                        if (slots[members[start[b] + j]] == slots[i]) {
+                            break;
+                        }
+                    }
+                    if (j < n) {
+                        break;
+                    }
+                }
+                if (n == size) {
+                    break;
+                }
+            }
+            if (seed >= ME_ESP_PERFECT_HASH_TRIES) {
+                /* Duplicate keys or pathological input */
+                return MPR_ERR_CANT_COMPLETE;
+            }
+            seeds[b] = seed;
+            for (k = 0; k < size; k++) {
+                used[slots[members[start[b] + k]]] = 1;
+            }
+        }
+    }
+    return 0;
+}
+
+
+/*
+    Create a perfect hash table from the keys and values of a hash. The hash must not be modified while the table
+    is in use as the table references the hash keys and values.
+ */
+PUBLIC EspPerfectHash *espCreatePerfectHash(MprHash *hash)
+{
+    EspPerfectHash  *table;
+    EspHashEntry    *entries;
+    MprKey          *kp;
+    cchar           **keys;
+    int             *seeds, *slots, count, i;
+
+    if ((count = mprGetHashLength(hash)) == 0) {
+        return 0;
+    }
+    if ((table = mprAllocObj(EspPerfectHash, managePerfectHash)) == 0) {
+        return 0;
+    }
+    keys = mprAlloc(count * sizeof(cchar*));
+    slots = mprAlloc(count * sizeof(int));
+    seeds = mprAlloc(count * sizeof(int));
+    entries = mprAllocZeroed(count * sizeof(EspHashEntry));
+    if (!keys || !slots || !seeds || !entries) {
+        return 0;
+    }
+    i = 0;
+    for (ITERATE_KEYS(hash, kp)) {
+        keys[i++] = kp->key;
+    }
+    if (espComputePerfectHash(keys, count, seeds, slots) < 0) {
+        return 0;
+    }
+    i = 0;
+    for (ITERATE_KEYS(hash, kp)) {
+        entries[slots[i]].key = kp->key;
+        entries[slots[i]].value = (void*) kp->data;
+        i++;
+    }
+    table->size = count;
+    table->seeds = seeds;
+    table->entries = entries;
+    return table;
+}
+
+
+static void managePerfectHash(EspPerfectHash *table, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark((void*) table->seeds);
+        mprMark((void*) table->entries);
+    }
+}
+
+
+PUBLIC void *espLookupPerfectHash(const EspPerfectHash *table, cchar *key)
+{
+    const EspHashEntry  *entry;
+
+    if (!table || table->size <= 0 || !key) {
+        return 0;
+    }
+    entry = &table->entries[hashKey(key, table->seeds[hashKey(key, 0) % table->size]) % table->size];
+    return (entry->key && smatch(entry->key, key)) ? entry->value : 0;
+}
+
+
 PUBLIC void espDestroySession(HttpStream *stream)
 {
     httpDestroySession(stream);
@@ -586,12 +921,12 @@ PUBLIC void espRedirectBack(HttpStream *stream)
 PUBLIC ssize espRender(HttpStream *stream, cchar *fmt, ...)
 {
     va_list     vargs;
-    char        *buf;
+    ssize       len;
 
     va_start(vargs, fmt);
-    buf = sfmtv(fmt, vargs);
+    len = httpWritev(stream->writeq, fmt, vargs);
     va_end(vargs);
-    return espRenderString(stream, buf);
+    return len;
 }
 
 
@@ -734,6 +1069,15 @@ PUBLIC ssize espRenderFile(HttpStream *stream, cchar *path)
 }
 
 
+PUBLIC void espRenderFragment(HttpStream *stream, cchar *key, MprTicks lifespan, EspViewProc proc)
+{
+    if (espBeginFragment(stream, key, lifespan)) {
+        (proc)(stream);
+        espEndFragment(stream);
+    }
+}
+
+
 PUBLIC ssize espRenderFeedback(HttpStream *stream, cchar *kinds)
 {
     EspReq      *req;
@@ -761,22 +1105,36 @@ PUBLIC ssize espRenderFeedback(HttpStream *stream, cchar *kinds)
 }
 
 
+/*
+    Format into a stack buffer and escape while writing. Only output too large for the buffer is allocated.
+ */
 PUBLIC ssize espRenderSafe(HttpStream *stream, cchar *fmt, ...)
 {
-    va_list     args;
+    va_list     args, ap;
+    char        buf[ME_BUFSIZE];
     cchar       *s;
 
     va_start(args, fmt);
-    s = mprEscapeHtml(sfmtv(fmt, args));
+    va_copy(ap, args);
+    s = fmtv(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (slen(s) >= sizeof(buf) - 1) {
+        s = sfmtv(fmt, args);
+    }
     va_end(args);
-    return espRenderBlock(stream, s, slen(s));
+    return httpWriteSafeString(stream->writeq, s);
 }
 
 
 PUBLIC ssize espRenderSafeString(HttpStream *stream, cchar *s)
 {
-    s = mprEscapeHtml(s);
-    return espRenderBlock(stream, s, slen(s));
+    return httpWriteSafeString(stream->writeq, s);
+}
+
+
+PUBLIC ssize espRenderStatic(HttpStream *stream, cchar *buf, ssize size)
+{
+    return httpWriteBlock(stream->writeq, buf, size, HTTP_BUFFER | HTTP_STATIC);
 }
 
 
@@ -893,6 +1251,50 @@ PUBLIC ssize espSendGrid(HttpStream *stream, EdiGrid *grid, int flags)
 }
 
 
+/*
+    Stream the records from a cursor. Records are written as they are read so the full result is never materialized.
+    Blocks (and may yield) when the write queue is full.
+ */
+PUBLIC ssize espSendCursor(HttpStream *stream, EdiCursor *cursor, int flags)
+{
+    HttpRoute   *route;
+    EspRoute    *eroute;
+    EdiRec      *rec;
+    cchar       *json;
+    ssize       written;
+    int         nrecords;
+
+    route = stream->rx->route;
+    if (!route->json) {
+        ediCloseCursor(cursor);
+        return 0;
+    }
+    httpSetContentType(stream, "application/json");
+    if (!cursor) {
+        return espRender(stream, "{data:[]}");
+    }
+    eroute = route->eroute;
+    flags = flags | (eroute->encodeTypes ? MPR_JSON_ENCODE_TYPES : 0);
+    mprAddRoot(cursor);
+    written = espRenderString(stream, "{\n  \"data\": [");
+    for (nrecords = 0; (rec = ediNextRec(cursor)) != 0; nrecords++) {
+        if (nrecords > 0) {
+            written += espRenderBlock(stream, ",", 1);
+        }
+        json = ediRecAsJson(rec, flags);
+        written += espRenderBlock(stream, json, slen(json));
+        if (stream->writeq->count >= stream->writeq->max) {
+            httpFlushQueue(stream->writeq, HTTP_BLOCK);
+        }
+    }
+    ediCloseCursor(cursor);
+    written += espRender(stream, "], \"count\": %d, \"schema\": %s}\n", cursor->count,
+        ediGetTableSchemaAsJson(cursor->edi, cursor->tableName));
+    mprRemoveRoot(cursor);
+    return written;
+}
+
+
 PUBLIC ssize espSendRec(HttpStream *stream, EdiRec *rec, int flags)
 {
     HttpRoute   *route;
@@ -8,6 +8,10 @@
 
 #include    "esp.h"
 
+#if ME_ESP_NOTIFY && !ME_STATIC
+    #include    <sys/inotify.h>
+#endif
+
 /************************************* Local **********************************/
 /*
     Singleton ESP control structure
@@ -24,6 +28,8 @@ static Esp *esp;
 static int cloneDatabase(HttpStream *stream);
 static void closeEsp(HttpQueue *q);
 static void ifConfigModified(HttpRoute *route, cchar *path, bool *modified);
+static EspAction *lookupAction(EspRoute *eroute, cchar *target);
+static EspViewProc lookupView(EspRoute *eroute, cchar *target);
 static void manageEsp(Esp *esp, int flags);
 static void manageReq(EspReq *req, int flags);
 static int openEsp(HttpQueue *q);
@@ -36,7 +42,23 @@ static cchar *getCacheName(HttpRoute *route, cchar *kind, cchar *source);
 static int espLoadModule(HttpRoute *route, MprDispatcher *dispatcher, cchar *kind, cchar *source, cchar **errMsg, bool *loaded);
 static cchar *getModuleName(HttpRoute *route, cchar *kind, cchar *target);
 static char *getModuleEntry(EspRoute *eroute, cchar *kind, cchar *source, cchar *cache);
-static bool layoutIsStale(EspRoute *eroute, cchar *source, cchar *module);
+static void addDependencies(HttpRoute *route, MprJson *files, cchar *path, cchar *data, cchar **layout, int depth);
+static cchar *addFileRecord(HttpRoute *route, MprJson *files, cchar *path);
+static bool buildChanged(HttpRoute *route, MprJson *record, cchar *module);
+static cchar *getBuildCommand(HttpRoute *route, cchar *rule, cchar *csource, cchar *module);
+static MprJson *getBuildRecord(cchar *module);
+static MprJson *getManifest(cchar *module);
+static void saveManifest(cchar *module);
+static bool updateDue(EspRoute *eroute, cchar *source, cchar *module);
+#if ME_COM_TCC
+static int loadViewInProcess(HttpRoute *route, cchar *source, cchar *module, cchar *cache, cchar **errMsg, bool *loaded);
+#endif
+#if ME_ESP_NOTIFY
+static void notifyUpdate(void *data, MprEvent *event);
+static void stopNotify(void);
+static void terminateEsp(int state, int how, int status);
+static void watchDir(cchar *dir);
+#endif
 #endif
 
 /************************************* Code ***********************************/
@@ -67,6 +89,13 @@ PUBLIC int espOpen(MprModule *module)
     handler->stageData = esp;
     esp->mutex = mprCreateLock();
     esp->local = mprCreateThreadLocal();
+#if ME_ESP_NOTIFY
+    esp->notifyFd = -1;
+#endif
+    if ((esp->fragments = mprCreateCache(0)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    mprSetCacheLimits(esp->fragments, 0, ESP_LIFESPAN, ME_ESP_FRAGMENT_MEMORY, 0);
 
     if (espInitParser() < 0) {
         return 0;
@@ -82,6 +111,14 @@ PUBLIC int espOpen(MprModule *module)
 #endif
     if (module) {
         mprSetModuleFinalizer(module, unloadEsp);
+#if ME_ESP_NOTIFY && !ME_STATIC
+    } else {
+        /*
+            Linked with the application. A loadable module closes the notifier when unloaded instead, so the
+            terminator does not refer to unloaded code.
+         */
+        mprAddTerminator(terminateEsp);
+#endif
     }
     return 0;
 }
@@ -94,6 +131,9 @@ static int unloadEsp(MprModule *mp)
     if (esp->inUse) {
        return MPR_ERR_BUSY;
     }
+#if ME_ESP_NOTIFY && !ME_STATIC
+    stopNotify();
+#endif
     if (mprIsStopping()) {
         return 0;
     }
@@ -175,6 +215,7 @@ static int openEsp(HttpQueue *q)
 
 static void closeEsp(HttpQueue *q)
 {
+    espCloseFragments(q->stream, 0);
     lock(esp);
     esp->inUse--;
     assert(esp->inUse >= 0);
@@ -424,7 +465,7 @@ static int runAction(HttpStream *stream)
     }
     httpAuthenticate(stream);
 
-    action = mprLookupKey(eroute->top->actions, rx->target);
+    action = lookupAction(eroute, rx->target);
     httpLog(stream->trace, "esp.handler", "context", "msg:Invoke controller action %s", rx->target);
 
     if (eroute->commonController) {
@@ -442,6 +483,34 @@ static int runAction(HttpStream *stream)
 }
 
 
+/*
+    Lookup an action. Combined apps use a perfect hash of the actions built when the app is loaded.
+ */
+static EspAction *lookupAction(EspRoute *eroute, cchar *target)
+{
+    EspAction   *action;
+
+    if (eroute->top->actionTable && (action = espLookupPerfectHash(eroute->top->actionTable, target)) != 0) {
+        return action;
+    }
+    return mprLookupKey(eroute->top->actions, target);
+}
+
+
+/*
+    Lookup a view. Combined apps define a static perfect hash of their views.
+ */
+static EspViewProc lookupView(EspRoute *eroute, cchar *target)
+{
+    EspViewProc     proc;
+
+    if (eroute->top->viewTable && (proc = espLookupPerfectHash(eroute->top->viewTable, target)) != 0) {
+        return proc;
+    }
+    return mprLookupKey(eroute->top->views, target);
+}
+
+
 /*
     Load a view ... may yield
  */
@@ -459,7 +528,7 @@ static bool loadView(HttpStream *stream, cchar *target)
     eroute = route->eroute;
     assert(eroute);
 
-    if (!eroute->combine && (eroute->update || !mprLookupKey(eroute->top->views, target))) {
+    if (!eroute->combine && (eroute->update || !lookupView(eroute, target))) {
         path = mprJoinPath(route->documents, target);
         httpLog(stream->trace, "esp.handler", "context", "msg:Loading module %s", path);
         /* May yield */
@@ -482,16 +551,19 @@ PUBLIC bool espRenderView(HttpStream *stream, cchar *target, int flags)
     HttpRoute   *route;
     EspRoute    *eroute;
     EspViewProc viewProc;
+    EspReq      *req;
+    int         depth;
 
     rx = stream->rx;
     route = rx->route;
     eroute = route->eroute;
+    req = stream->reqData;
 
     /* WARNING: may yield */
     if (!loadView(stream, target)) {
         return 0;
     }
-    if ((viewProc = mprLookupKey(eroute->top->views, target)) == 0) {
+    if ((viewProc = lookupView(eroute, target)) == 0) {
         httpError(stream, HTTP_CODE_NOT_FOUND, "Cannot find view %s", target);
         return 0;
     }
@@ -502,8 +574,11 @@ PUBLIC bool espRenderView(HttpStream *stream, cchar *target, int flags)
         }
         httpSetContentType(stream, "text/html");
         httpSetFilename(stream, mprJoinPath(route->documents, target), 0);
+        depth = (req && req->fragments) ? mprGetListLength(req->fragments) : 0;
         /* WARNING: may yield */
         (viewProc)(stream);
+        /* Restore the write queue limit if the view returned inside a fragment */
+        espCloseFragments(stream, depth);
     }
     return 1;
 }
@@ -545,7 +620,7 @@ static cchar *checkView(HttpStream *stream, cchar *target, cchar *filename, ccha
     /*
         See if module already loaded for this view
      */
-    if (mprLookupKey(eroute->top->views, target)) {
+    if (lookupView(eroute, target)) {
         return target;
     }
 
@@ -774,6 +849,9 @@ static int espLoadModule(HttpRoute *route, MprDispatcher *dispatcher, cchar *kin
     MprModule   *mp;
     cchar       *cacheDir, *cache, *entry, *module;
     int         isView, recompile;
+#if ME_COM_TCC
+    int         rc;
+#endif
 
     eroute = route->eroute;
     *errMsg = "";
@@ -790,11 +868,18 @@ static int espLoadModule(HttpRoute *route, MprDispatcher *dispatcher, cchar *kin
     module = mprJoinPathExt(mprJoinPaths(route->home, cacheDir, cache, NULL), ME_SHOBJ);
 
     lock(esp);
-    if (mprLookupModule(source) == 0 || eroute->update) {
+#if ME_COM_TCC
+    if (eroute->inProcess && eroute->compile && smatch(kind, "view") && mprPathExists(source, R_OK)) {
+        rc = loadViewInProcess(route, source, module, cache, errMsg, loaded);
+        unlock(esp);
+        return rc;
+    }
+#endif
+    if (mprLookupModule(source) == 0 || (eroute->update && updateDue(eroute, source, module))) {
         espModuleIsStale(route, source, module, &recompile);
         if (eroute->compile && mprPathExists(source, R_OK)) {
             isView = smatch(kind, "view");
-            if (recompile || (isView && layoutIsStale(eroute, source, module))) {
+            if (recompile || (isView && espLayoutIsStale(route, source, module))) {
                 if (recompile) {
                     /*
                         WARNING: espCompile may yield. espCompile will retain the arguments (source, module, cache) for us.
@@ -833,17 +918,165 @@ static int espLoadModule(HttpRoute *route, MprDispatcher *dispatcher, cchar *kin
 }
 
 
+#if ME_COM_TCC
+/*
+    Compile and load a view in-process with the embedded compiler. No module file is created. The build is recorded
+    in the cache manifest against the module name so updates are detected in the same way as for compiled modules.
+    Called with the esp lock held. WARNING: may yield while unloading a prior version.
+ */
+static int loadViewInProcess(HttpRoute *route, cchar *source, cchar *module, cchar *cache, cchar **errMsg, bool *loaded)
+{
+    EspRoute    *eroute;
+    MprJson     *record;
+
+    eroute = route->eroute;
+    if (mprLookupModule(source)) {
+        if (!eroute->update || !updateDue(eroute, source, module)) {
+            return 0;
+        }
+        if ((record = getBuildRecord(module)) != 0 && !buildChanged(route, record, module)) {
+            return 0;
+        }
+        if (!espUnloadModule(source, ME_ESP_RELOAD_TIMEOUT)) {
+            mprLog("warn esp", 4, "Cannot unload module %s. Streams still open. Continue using old version.", source);
+            return 0;
+        }
+        mprLog("info esp", 4, "Source %s has changed, recompiling in-process ...", source);
+    }
+    if (!espCompileInProcess(route, source, module, cache, (char**) errMsg)) {
+        return MPR_ERR_CANT_LOAD;
+    }
+    if (loaded) {
+        *loaded = 1;
+    }
+    return 0;
+}
+#endif
+
+
+/*
+    Test if a loaded module is due to be checked for updates. Modules are checked at most once per
+    eroute->updateInterval. If inotify is available, changes to the source, layout or cache directories cancel
+    the interval so updates are seen by the next request. Called with the esp lock held.
+ */
+static bool updateDue(EspRoute *eroute, cchar *source, cchar *module)
+{
+    MprTicks    *checked, now;
+
+    if (eroute->updateInterval <= 0) {
+        return 1;
+    }
+    now = mprGetTicks();
+    if (!esp->checked) {
+        esp->checked = mprCreateHash(0, 0);
+    }
+    if ((checked = mprLookupKey(esp->checked, source)) == 0) {
+        if ((checked = mprAlloc(sizeof(MprTicks))) == 0) {
+            return 1;
+        }
+        mprAddKey(esp->checked, source, checked);
+    } else if ((now - *checked) < eroute->updateInterval) {
+        return 0;
+    }
+    *checked = now;
+#if ME_ESP_NOTIFY
+    watchDir(mprGetPathDir(source));
+    watchDir(mprGetPathDir(module));
+    watchDir(httpGetDir(eroute->route, "LAYOUTS"));
+#endif
+    return 1;
+}
+
+
+#if ME_ESP_NOTIFY
+/*
+    Watch a directory for updates. The inotify instance is created on first use.
+ */
+static void watchDir(cchar *dir)
+{
+    if (!dir) {
+        return;
+    }
+    if (!esp->watches) {
+        esp->watches = mprCreateHash(0, 0);
+        if ((esp->notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0) {
+            mprLog("warn esp", 2, "Cannot initialize inotify, errno %d", mprGetOsError());
+            return;
+        }
+        esp->notifyHandler = mprCreateWaitHandler(esp->notifyFd, MPR_READABLE, NULL, notifyUpdate, NULL, 0);
+    }
+    if (esp->notifyFd < 0 || mprLookupKey(esp->watches, dir)) {
+        return;
+    }
+    if (inotify_add_watch(esp->notifyFd, dir,
+            IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0) {
+        mprLog("warn esp", 2, "Cannot watch %s for updates, errno %d", dir, mprGetOsError());
+        return;
+    }
+    mprAddKey(esp->watches, dir, dir);
+}
+
+
+/*
+    A watched directory has changed. Discard all check times so modules are checked on their next request.
+ */
+static void notifyUpdate(void *data, MprEvent *event)
+{
+    char    buf[4096];
+
+    if (esp->notifyFd < 0) {
+        return;
+    }
+    while (read(esp->notifyFd, buf, sizeof(buf)) > 0) ;
+    lock(esp);
+    esp->checked = 0;
+    unlock(esp);
+    mprWaitOn(esp->notifyHandler, MPR_READABLE);
+}
+
+
+/*
+    Stop watching for updates and close the inotify instance
+ */
+static void stopNotify()
+{
+    lock(esp);
+    if (esp->notifyHandler) {
+        mprDestroyWaitHandler(esp->notifyHandler);
+        esp->notifyHandler = 0;
+    }
+    if (esp->notifyFd >= 0) {
+        close(esp->notifyFd);
+        esp->notifyFd = -1;
+    }
+    esp->watches = 0;
+    unlock(esp);
+}
+
+
+static void terminateEsp(int state, int how, int status)
+{
+    if (state >= MPR_STOPPED) {
+        stopNotify();
+    }
+}
+#endif
+
+
 /*
     Test if a module has been updated (is stale).
     This will unload the module if it loaded but stale.
-    Set recompile to true if the source is absent or more recent.
+    Set recompile to true if the source is absent or has changed. If the build manifest has a record for the module,
+    the recorded content hashes of the source and its dependencies are used. Otherwise, modification times are compared.
     Will return false if the source does not exist (important for testing layouts).
  */
 PUBLIC bool espModuleIsStale(HttpRoute *route, cchar *source, cchar *module, int *recompile)
 {
     EspRoute    *eroute;
     MprModule   *mp;
+    MprJson     *record;
     MprPath     sinfo, minfo;
+    bool        changed;
 
     *recompile = 0;
     eroute = route->eroute;
@@ -864,8 +1097,13 @@ PUBLIC bool espModuleIsStale(HttpRoute *route, cchar *source, cchar *module, int
         return 1;
     }
     if (eroute->compile) {
-        mprGetPathInfo(source, &sinfo);
-        if (sinfo.valid && sinfo.mtime > minfo.mtime) {
+        if ((record = getBuildRecord(module)) != 0) {
+            changed = buildChanged(route, record, module);
+        } else {
+            mprGetPathInfo(source, &sinfo);
+            changed = sinfo.valid && sinfo.mtime > minfo.mtime;
+        }
+        if (changed) {
             if ((mp = mprLookupModule(source)) != 0) {
                 if (!espUnloadModule(source, ME_ESP_RELOAD_TIMEOUT)) {
                     mprLog("warn esp", 4, "Cannot unload module %s. Streams still open. Continue using old version.",
@@ -874,7 +1112,7 @@ PUBLIC bool espModuleIsStale(HttpRoute *route, cchar *source, cchar *module, int
                 }
             }
             *recompile = 1;
-            mprLog("info esp", 4, "Source %s is newer than module %s, recompiling ...", source, module);
+            mprLog("info esp", 4, "Source %s has changed since module %s was built, recompiling ...", source, module);
             return 1;
         }
     }
@@ -897,8 +1135,9 @@ PUBLIC bool espModuleIsStale(HttpRoute *route, cchar *source, cchar *module, int
 
 /*
     Check if the layout has changed. Returns false if the layout does not exist.
+    Modules with a build manifest record have their layout checked by espModuleIsStale and the source is not read.
  */
-static bool layoutIsStale(EspRoute *eroute, cchar *source, cchar *module)
+PUBLIC bool espLayoutIsStale(HttpRoute *route, cchar *source, cchar *module)
 {
     char    *data, *lpath, *quote;
     cchar   *layout, *layoutsDir;
@@ -906,8 +1145,11 @@ static bool layoutIsStale(EspRoute *eroute, cchar *source, cchar *module)
     bool    stale;
     int     recompile;
 
+    if (getBuildRecord(module)) {
+        return 0;
+    }
     stale = 0;
-    layoutsDir = httpGetDir(eroute->route, "LAYOUTS");
+    layoutsDir = httpGetDir(route, "LAYOUTS");
     if ((data = mprReadPathContents(source, &len)) != 0) {
         if ((lpath = scontains(data, "@ layout \"")) != 0) {
             lpath = strim(&lpath[10], " ", MPR_TRIM_BOTH);
@@ -919,7 +1161,7 @@ static bool layoutIsStale(EspRoute *eroute, cchar *source, cchar *module)
             layout = (layoutsDir) ? mprJoinPath(layoutsDir, "default.esp") : 0;
         }
         if (layout) {
-            stale = espModuleIsStale(eroute->route, layout, module, &recompile);
+            stale = espModuleIsStale(route, layout, module, &recompile);
             if (stale) {
                 mprLog("info esp", 4, "esp layout %s is newer than module %s", layout, module);
             }
@@ -927,12 +1169,276 @@ static bool layoutIsStale(EspRoute *eroute, cchar *source, cchar *module)
     }
     return stale;
 }
+
+
+/*
+    Record a successfully built module in the build manifest. The manifest is saved in the cache directory and
+    records the content hash, size and modification time of the source and its include and layout dependencies,
+    and a hash of the compiler commands. The layout is the default layout for views and null otherwise.
+    The csource is null for views compiled in-process and no compiler command is recorded.
+    The rule is the compiler rule that built the module: "object" or "combine" for a combined app, or null if the
+    module was built by the "compile" and "link" rules.
+ */
+PUBLIC void espRecordModule(HttpRoute *route, cchar *source, cchar *csource, cchar *module, cchar *layout,
+    cchar *rule)
+{
+    MprJson     *manifest, *record, *files;
+    cchar       *data;
+
+    lock(esp);
+    if ((manifest = getManifest(module)) == 0) {
+        unlock(esp);
+        return;
+    }
+    record = mprCreateJson(MPR_JSON_OBJ);
+    files = mprCreateJson(MPR_JSON_OBJ);
+    if ((data = addFileRecord(route, files, source)) == 0) {
+        if ((record = mprReadJsonObj(manifest, mprGetPathBase(module))) != 0) {
+            mprRemoveJsonChild(manifest, record);
+        }
+        unlock(esp);
+        return;
+    }
+    addDependencies(route, files, source, data, &layout, 0);
+    if (layout && (data = addFileRecord(route, files, layout)) != 0) {
+        addDependencies(route, files, layout, data, NULL, 0);
+    }
+    if (csource) {
+        mprWriteJson(record, "csource", mprGetRelPath(csource, route->home), MPR_JSON_STRING);
+        if (rule) {
+            mprWriteJson(record, "rule", rule, MPR_JSON_STRING);
+        }
+        mprWriteJson(record, "command", getBuildCommand(route, rule, csource, module), MPR_JSON_STRING);
+    }
+    mprWriteJsonObj(record, "files", files);
+    mprWriteJsonObj(manifest, mprGetPathBase(module), record);
+    saveManifest(module);
+    unlock(esp);
+}
+
+
+/*
+    Scan an esp page for include and layout control directives and record the referenced files.
+    If layout is not null, it is updated with the layout selected by the page.
+ */
+static void addDependencies(HttpRoute *route, MprJson *files, cchar *path, cchar *data, cchar **layout, int depth)
+{
+    cchar   *cp, *end, *layoutsDir, *dep, *incData;
+    char    *token;
+
+    if (depth > 16) {
+        return;
+    }
+    for (cp = data; (cp = scontains(cp, "<%^")) != 0; cp = end) {
+        for (cp += 3; isspace((uchar) *cp); cp++) ;
+        if ((end = scontains(cp, "%>")) == 0) {
+            break;
+        }
+        if (sstarts(cp, "include")) {
+            token = strim(snclone(&cp[7], end - cp - 7), " \t\r\n\"", MPR_TRIM_BOTH);
+            token = mprNormalizePath(token);
+            dep = (token[0] == '/') ? token : mprJoinPath(mprGetPathDir(path), token);
+            if (!mprReadJsonObj(files, mprGetRelPath(dep, route->home)) &&
+                    (incData = addFileRecord(route, files, dep)) != 0) {
+                addDependencies(route, files, dep, incData, NULL, depth + 1);
+            }
+
+        } else if (sstarts(cp, "layout") && layout) {
+            token = strim(snclone(&cp[6], end - cp - 6), " \t\r\n\"", MPR_TRIM_BOTH);
+            if (*token == '\0') {
+                *layout = 0;
+            } else {
+                token = mprNormalizePath(token);
+                if (token[0] == '/') {
+                    *layout = token;
+                } else if ((layoutsDir = httpGetDir(route, "LAYOUTS")) != 0) {
+                    *layout = mprJoinPath(layoutsDir, token);
+                } else {
+                    *layout = mprJoinPath(mprGetPathDir(path), token);
+                }
+            }
+        }
+    }
+}
+
+
+/*
+    Hash a file and add its record to the files object. Returns the file contents.
+ */
+static cchar *addFileRecord(HttpRoute *route, MprJson *files, cchar *path)
+{
+    MprJson     *file;
+    MprPath     info;
+    char        *data;
+    ssize       len;
+
+    mprGetPathInfo(path, &info);
+    if (!info.valid || (data = mprReadPathContents(path, &len)) == 0) {
+        return 0;
+    }
+    file = mprCreateJson(MPR_JSON_OBJ);
+    mprWriteJson(file, "hash", mprGetMD5WithPrefix(data, len, NULL), MPR_JSON_STRING);
+    mprWriteJson(file, "size", itos(info.size), MPR_JSON_NUMBER);
+    mprWriteJson(file, "mtime", itos(info.mtime), MPR_JSON_NUMBER);
+    mprWriteJsonObj(files, mprGetRelPath(path, route->home), file);
+    return data;
+}
+
+
+/*
+    Test if any recorded file or the compiler command has changed since the module was built.
+    Files are only read if their size or modification time differ from the recorded values. If the content is
+    unchanged, the new modification time is recorded so the file is not read again.
+ */
+static bool buildChanged(HttpRoute *route, MprJson *record, cchar *module)
+{
+    MprJson     *files, *file;
+    MprPath     info;
+    cchar       *path, *command, *csource;
+    char        *data;
+    ssize       len;
+    bool        changed, updated;
+    int         index;
+
+    changed = updated = 0;
+    files = mprReadJsonObj(record, "files");
+    for (ITERATE_JSON(files, file, index)) {
+        path = mprJoinPath(route->home, file->name);
+        mprGetPathInfo(path, &info);
+        if (!info.valid) {
+            changed = 1;
+            break;
+        }
+        if (info.size == stoi(mprReadJson(file, "size")) && info.mtime == stoi(mprReadJson(file, "mtime"))) {
+            continue;
+        }
+        if ((data = mprReadPathContents(path, &len)) == 0 ||
+                !smatch(mprGetMD5WithPrefix(data, len, NULL), mprReadJson(file, "hash"))) {
+            changed = 1;
+            break;
+        }
+        mprWriteJson(file, "size", itos(info.size), MPR_JSON_NUMBER);
+        mprWriteJson(file, "mtime", itos(info.mtime), MPR_JSON_NUMBER);
+        updated = 1;
+    }
+    if (!changed && (csource = mprReadJson(record, "csource")) != 0) {
+        command = getBuildCommand(route, mprReadJson(record, "rule"), csource, module);
+        if (command && !smatch(command, mprReadJson(record, "command"))) {
+            mprLog("info esp", 4, "Compiler command for %s has changed", module);
+            changed = 1;
+        }
+    }
+    if (updated) {
+        saveManifest(module);
+    }
+    return changed;
+}
+
+
+/*
+    Get a hash of the expanded commands that build a module with the given rule. Paths are made relative to the
+    route home so the hash does not depend on how the source was located. The "object" rule compiles an object of
+    a combined app. The "combine" rule links the combined module. Its object list is not expanded as the objects
+    are determined by the combined entry source. Otherwise, the hash is of the compile and link commands.
+ */
+static cchar *getBuildCommand(HttpRoute *route, cchar *rule, cchar *csource, cchar *module)
+{
+    EspRoute    *eroute;
+    cchar       *command;
+
+    eroute = route->eroute;
+    if (!eroute->compileCmd && espLoadCompilerRules(route) < 0) {
+        return 0;
+    }
+    csource = mprGetRelPath(csource, route->home);
+    module = mprGetRelPath(module, route->home);
+    if (smatch(rule, "object")) {
+        return eroute->objectCmd ? mprGetMD5(espExpandCommand(route, eroute->objectCmd, csource, module)) : 0;
+    } else if (smatch(rule, "combine")) {
+        return eroute->combineCmd ? mprGetMD5(espExpandCommand(route, eroute->combineCmd, csource, module)) : 0;
+    }
+    if (!eroute->compileCmd) {
+        return 0;
+    }
+    command = espExpandCommand(route, eroute->compileCmd, csource, module);
+    if (eroute->linkCmd) {
+        command = sjoin(command, "\n", espExpandCommand(route, eroute->linkCmd, csource, module), NULL);
+    }
+    return mprGetMD5(command);
+}
+
+
+static MprJson *getBuildRecord(cchar *module)
+{
+    MprJson     *manifest;
+
+    if ((manifest = getManifest(module)) == 0) {
+        return 0;
+    }
+    return mprReadJsonObj(manifest, mprGetPathBase(module));
+}
+
+
+/*
+    Get the build manifest for the cache directory containing a module. Manifests are loaded once and retained.
+ */
+static MprJson *getManifest(cchar *module)
+{
+    MprJson     *manifest;
+    cchar       *path;
+
+    path = mprJoinPath(mprGetPathDir(module), ESP_MANIFEST);
+    lock(esp);
+    if (!esp->manifests) {
+        esp->manifests = mprCreateHash(0, 0);
+    }
+    if ((manifest = mprLookupKey(esp->manifests, path)) == 0) {
+        if ((manifest = mprLoadJson(path)) == 0) {
+            manifest = mprCreateJson(MPR_JSON_OBJ);
+        }
+        mprAddKey(esp->manifests, path, manifest);
+    }
+    unlock(esp);
+    return manifest;
+}
+
+
+/*
+    Save the build manifest. Write to a temporary file and rename so readers never see a partial manifest.
+ */
+static void saveManifest(cchar *module)
+{
+    MprJson     *manifest;
+    cchar       *path, *tmp;
+
+    if ((manifest = getManifest(module)) == 0) {
+        return;
+    }
+    path = mprJoinPath(mprGetPathDir(module), ESP_MANIFEST);
+    tmp = sfmt("%s.tmp", path);
+    if (mprSaveJson(manifest, tmp, MPR_JSON_PRETTY | MPR_JSON_QUOTES) < 0 || rename(tmp, path) < 0) {
+        mprLog("error esp", 0, "Cannot save build manifest %s", path);
+        mprDeletePath(tmp);
+    }
+}
 #else
 
+PUBLIC bool espLayoutIsStale(HttpRoute *route, cchar *source, cchar *module)
+{
+    return 0;
+}
+
+
 PUBLIC bool espModuleIsStale(HttpRoute *route, cchar *source, cchar *module, int *recompile)
 {
     return 0;
 }
+
+
+PUBLIC void espRecordModule(HttpRoute *route, cchar *source, cchar *csource, cchar *module, cchar *layout,
+    cchar *rule)
+{
+}
 #endif /* ME_STATIC */
 
 
@@ -944,13 +1450,16 @@ PUBLIC void espManageEspRoute(EspRoute *eroute, int flags)
 {
     if (flags & MPR_MANAGE_MARK) {
         mprMark(eroute->actions);
+        mprMark(eroute->actionTable);
         mprMark(eroute->appName);
+        mprMark(eroute->combineCmd);
         mprMark(eroute->compileCmd);
         mprMark(eroute->configFile);
         mprMark(eroute->currentSession);
         mprMark(eroute->edi);
         mprMark(eroute->env);
         mprMark(eroute->linkCmd);
+        mprMark(eroute->objectCmd);
         mprMark(eroute->searchPath);
         mprMark(eroute->top);
         mprMark(eroute->views);
@@ -1009,14 +1518,22 @@ static EspRoute *cloneEspRoute(HttpRoute *route, EspRoute *parent)
     if (parent->linkCmd) {
         eroute->linkCmd = sclone(parent->linkCmd);
     }
+    if (parent->objectCmd) {
+        eroute->objectCmd = sclone(parent->objectCmd);
+    }
+    if (parent->combineCmd) {
+        eroute->combineCmd = sclone(parent->combineCmd);
+    }
     if (parent->env) {
         eroute->env = mprCloneHash(parent->env);
     }
     eroute->appName = parent->appName;
     eroute->combine = parent->combine;
     eroute->compile = parent->compile;
+    eroute->inProcess = parent->inProcess;
     eroute->keep = parent->keep;
     eroute->update = parent->update;
+    eroute->updateInterval = parent->updateInterval;
 #if DEPRECATED
     eroute->combineScript = parent->combineScript;
     eroute->combineSheet = parent->combineSheet;
@@ -1073,6 +1590,7 @@ static void manageReq(EspReq *req, int flags)
         mprMark(req->data);
         mprMark(req->edi);
         mprMark(req->feedback);
+        mprMark(req->fragments);
         mprMark(req->lastFeedback);
         mprMark(req->route);
     }
@@ -1089,6 +1607,13 @@ static void manageEsp(Esp *esp, int flags)
         mprMark(esp->databasesTimer);
         mprMark(esp->ediService);
         mprMark(esp->internalOptions);
+        mprMark(esp->manifests);
+        mprMark(esp->checked);
+        mprMark(esp->fragments);
+#if ME_ESP_NOTIFY
+        mprMark(esp->watches);
+        mprMark(esp->notifyHandler);
+#endif
         mprMark(esp->local);
         mprMark(esp->mutex);
         mprMark(esp->vstudioEnv);
@@ -1179,6 +1704,10 @@ static bool preload(HttpRoute *route)
                 mprLog("error esp", 0, "%s", errMsg);
                 return 0;
             }
+            /* The set of actions is now complete */
+            if (eroute->top->actions) {
+                eroute->top->actionTable = espCreatePerfectHash(eroute->top->actions);
+            }
         } else {
             if ((sources = mprGetJsonObj(route->config, "esp.app.source")) != 0) {
                 for (ITERATE_JSON(sources, si, index)) {
@@ -1341,6 +1870,9 @@ PUBLIC int espOpenDatabase(HttpRoute *route, cchar *spec)
     if ((eroute->edi = ediOpen(mprGetRelPath(path, NULL), provider, flags)) == 0) {
         return MPR_ERR_CANT_OPEN;
     }
+    if (ediConfigure(eroute->edi, mprGetJsonObj(route->config, "esp.sqlite")) < 0) {
+        mprLog("error esp", 0, "Bad esp.sqlite configuration for %s", path);
+    }
     route->database = sclone(spec);
     return 0;
 }
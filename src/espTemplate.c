@@ -8,6 +8,10 @@
 
 #include    "esp.h"
 
+#if ME_COM_TCC
+    #include    "libtcc.h"
+#endif
+
 /************************************ Defines *********************************/
 /*
       ESP lexical analyser tokens
@@ -26,6 +30,12 @@
 #define ESP_TOK_SERVER          9            /* %| Server URL  */
 #endif
 
+/*
+    Literal text markers. Literals are coalesced into a single write per run after includes and layouts are expanded.
+ */
+#define ESP_LITERAL_START       "${_ESP_LITERAL_START_}"
+#define ESP_LITERAL_END         "${_ESP_LITERAL_END_}"
+
 /*
     ESP page parser structure
  */
@@ -64,6 +74,11 @@ static cchar *getVxCPU(cchar *arch);
 static void manageContext(CompileContext *context, int flags);
 static bool matchToken(cchar **str, cchar *token);
 
+#if ME_COM_TCC
+static void tccError(void *data, cchar *msg);
+static int tccStop(MprModule *mp);
+#endif
+
 #if ME_WIN_LIKE
 static cchar *getWinSDK(HttpRoute *route);
 static cchar *getWinVer(HttpRoute *route);
@@ -83,6 +98,7 @@ static cchar *getWinVer(HttpRoute *route);
     LIBPATH     Library search path
     LIBS        Libraries required to link with ESP
     OBJ         Name of compiled source (out/lib/view-MD5.o)
+    OBJS        Objects to link into a combined app (combine rule only)
     MOD         Output module (view_MD5)
     SHLIB       Host Shared library (.lib, .so)
     SHOBJ       Host Shared Object (.dll, .so)
@@ -433,6 +449,13 @@ PUBLIC bool espCompile(HttpRoute *route, MprDispatcher *dispatcher, cchar *sourc
         }
     }
 #endif
+    layout = 0;
+#if DEPRECATED || 1
+    if (isView && (layoutsDir = httpGetDir(route, "LAYOUTS")) != 0) {
+        layout = mprJoinPath(layoutsDir, "default.esp");
+    }
+#endif
+    espRecordModule(route, context->source, context->csource, context->module, layout, NULL);
     if (!eroute->keep && isView) {
         mprDeletePath(csource);
     }
@@ -441,6 +464,112 @@ PUBLIC bool espCompile(HttpRoute *route, MprDispatcher *dispatcher, cchar *sourc
 }
 
 
+#if ME_COM_TCC
+/*
+    Compile a view in-process with the embedded compiler (libtcc) and load it from memory. This avoids writing the
+    C source, running the external compiler and linker, and loading a shared library. Symbols referenced by the view
+    are resolved against the running program, so ESP must be linked with exported symbols or as a shared library.
+    The compiled code is retained until the module is unloaded.
+ */
+PUBLIC bool espCompileInProcess(HttpRoute *route, cchar *source, cchar *module, cchar *cacheName, char **errMsg)
+{
+    Http            *http;
+    TCCState        *state;
+    MprBuf          *errors;
+    MprModule       *mp;
+    MprModuleEntry  entry;
+    cchar           *layoutsDir, *path, *srcDir;
+    char            *layout, *script, *page, *err, *entryName;
+    ssize           len;
+
+    http = MPR->httpService;
+    layout = 0;
+    *errMsg = 0;
+
+    mprLog("info esp", 2, "Compile in-process %s", source);
+    if ((page = mprReadPathContents(source, &len)) == 0) {
+        *errMsg = sfmt("Cannot read %s", source);
+        return 0;
+    }
+#if DEPRECATED || 1
+    if ((layoutsDir = httpGetDir(route, "LAYOUTS")) != 0) {
+        layout = mprJoinPath(layoutsDir, "default.esp");
+    }
+#endif
+    if ((script = espBuildScript(route, page, source, cacheName, layout, NULL, &err)) == 0) {
+        *errMsg = sfmt("Cannot build: %s, error: %s", source, err);
+        return 0;
+    }
+    if ((state = tcc_new()) == 0) {
+        *errMsg = "Cannot create embedded compiler";
+        return 0;
+    }
+    errors = mprCreateBuf(0, 0);
+    tcc_set_error_func(state, errors, (void (*)(void*, const char*)) tccError);
+    if (*(path = getEnvString(route, "TCCLIB", ""))) {
+        /* Location of the compiler runtime library and headers if not installed in the default location */
+        tcc_set_lib_path(state, path);
+    }
+    tcc_set_output_type(state, TCC_OUTPUT_MEMORY);
+    if ((srcDir = httpGetDir(route, "SRC")) == 0) {
+        srcDir = ".";
+    }
+    tcc_add_include_path(state, getEnvString(route, "APPINC", srcDir));
+    tcc_add_include_path(state, mprJoinPath(http->platformDir, "inc"));
+
+    entryName = sfmt("esp_%s", cacheName);
+    if (tcc_compile_string(state, script) < 0 || tcc_relocate(state, TCC_RELOCATE_AUTO) < 0 ||
+            (entry = (MprModuleEntry) tcc_get_symbol(state, entryName)) == 0) {
+        mprAddNullToBuf(errors);
+        mprLog("error esp", 0, "Cannot compile %s, error %s", source, mprGetBufStart(errors));
+        if (route->flags & HTTP_ROUTE_SHOW_ERRORS) {
+            *errMsg = sfmt("Cannot compile %s, error %s", source, mprGetBufStart(errors));
+        } else {
+            *errMsg = "Cannot compile view";
+        }
+        tcc_delete(state);
+        return 0;
+    }
+    /*
+        The module has no path and is not flagged as loaded so mprUnloadModule will not dlclose the handle.
+        The compiled code is freed by tccStop when the module is stopped.
+     */
+    if ((mp = mprCreateModule(source, NULL, entryName, route)) == 0) {
+        *errMsg = "Memory allocation error loading module";
+        tcc_delete(state);
+        return 0;
+    }
+    mp->handle = state;
+    mp->modified = mprGetTime();
+    mp->stop = tccStop;
+    if ((entry)(route, mp) < 0 || mprStartModule(mp) < 0) {
+        *errMsg = sfmt("Initialization for %s failed", source);
+        mprUnloadModule(mp);
+        tcc_delete(state);
+        return 0;
+    }
+    espRecordModule(route, source, NULL, module, layout, NULL);
+    return 1;
+}
+
+
+static void tccError(void *data, cchar *msg)
+{
+    mprPutToBuf((MprBuf*) data, "%s\n", msg);
+}
+
+
+static int tccStop(MprModule *mp)
+{
+    if (mp->handle) {
+        tcc_delete((TCCState*) mp->handle);
+        mp->handle = 0;
+    }
+    return 0;
+}
+#endif
+
+
 static char *fixMultiStrings(cchar *str)
 {
     cchar   *cp;
@@ -497,6 +626,7 @@ static char *joinLine(cchar *str, ssize *lenp)
      */
     len = slen(str);
     if ((buf = mprAlloc(len + (count * 3) + 1)) == 0) {
+        *lenp = 0;
         return 0;
     }
     bquote = 0;
@@ -523,6 +653,42 @@ static char *joinLine(cchar *str, ssize *lenp)
 }
 
 
+/*
+    Replace literal markers with calls to render the literal text. Adjacent literals, including those split by
+    directives that emit no code or joined by includes and layouts, are written by a single espRenderStatic call.
+    The literal text is a string constant in the compiled module, so it is queued by reference.
+ */
+static char *renderLiterals(cchar *code)
+{
+    MprBuf  *buf, *run;
+    cchar   *cp, *start, *end;
+    char    *line;
+    ssize   len;
+
+    buf = mprCreateBuf(0, 0);
+    run = mprCreateBuf(0, 0);
+    for (cp = code; (start = scontains(cp, ESP_LITERAL_START)) != 0; ) {
+        mprPutBlockToBuf(buf, cp, start - cp);
+        mprFlushBuf(run);
+        for (cp = start; sstarts(cp, ESP_LITERAL_START); cp = &end[sizeof(ESP_LITERAL_END) - 1]) {
+            start = &cp[sizeof(ESP_LITERAL_START) - 1];
+            if ((end = scontains(start, ESP_LITERAL_END)) == 0) {
+                return 0;
+            }
+            mprPutBlockToBuf(run, start, end - start);
+        }
+        mprAddNullToBuf(run);
+        if ((line = joinLine(mprGetBufStart(run), &len)) == 0) {
+            return 0;
+        }
+        mprPutToBuf(buf, "  espRenderStatic(stream, \"%s\", %zd);\n", line, len);
+    }
+    mprPutStringToBuf(buf, cp);
+    mprAddNullToBuf(buf);
+    return mprGetBufStart(buf);
+}
+
+
 /*
     Convert an ESP web page into C code
     Directives:
@@ -537,6 +703,9 @@ static char *joinLine(cchar *str, ssize *lenp)
         <%^ global          Put esp code at the global level
         <%^ start           Put esp code at the start of the function
         <%^ end             Put esp code at the end of the function
+        <%^ fragment [lifespan] key
+                            Begin a fragment whose rendered output is cached using the key expression
+        <%^ endfragment     End a cached fragment
 
         %!var               Substitue the value of a parameter.
         %$param             Substitue the value of a request parameter.
@@ -557,8 +726,9 @@ PUBLIC char *espBuildScript(HttpRoute *route, cchar *page, cchar *path, cchar *c
     MprBuf      *body;
     cchar       *layoutsDir;
     char        *control, *incText, *where, *layoutCode, *bodyCode;
-    char        *rest, *include, *line, *fmt, *layoutPage, *incCode, *token;
+    char        *rest, *include, *fmt, *layoutPage, *incCode, *token;
     ssize       len;
+    int64       lifespan;
     int         tid;
 
     assert(page);
@@ -567,7 +737,7 @@ PUBLIC char *espBuildScript(HttpRoute *route, cchar *page, cchar *path, cchar *c
     if (!state) {
         assert(cacheName);
         state = &top;
-        memset(state, 0, sizeof(EspParse));
+        memset(state, 0, sizeof(EspState));
         state->global = mprCreateBuf(0, 0);
         state->start = mprCreateBuf(0, 0);
         state->end = mprCreateBuf(0, 0);
@@ -667,6 +837,27 @@ PUBLIC char *espBuildScript(HttpRoute *route, cchar *page, cchar *path, cchar *c
             } else if (smatch(control, "end")) {
                 mprPutToBuf(state->end, "%s  ", token);
 
+            } else if (smatch(control, "fragment")) {
+                token = strim(token, " \t\r\n", MPR_TRIM_BOTH);
+                lifespan = 0;
+                if (isdigit((uchar) *token)) {
+                    lifespan = httpGetTicks(ssplit(token, " \t\r\n", &token));
+                }
+                if (*token == '\0') {
+                    *err = sfmt("Missing fragment key at line %d", parse.lineNumber);
+                    return 0;
+                }
+                mprPutToBuf(body, "  if (espBeginFragment(stream, %s, %lld)) {\n", token, lifespan);
+                state->fragments++;
+
+            } else if (smatch(control, "endfragment")) {
+                if (state->fragments <= 0) {
+                    *err = sfmt("Endfragment without fragment at line %d", parse.lineNumber);
+                    return 0;
+                }
+                mprPutStringToBuf(body, "  espEndFragment(stream);\n  }\n");
+                state->fragments--;
+
             } else {
                 *err = sfmt("Unknown control %s at line %d", control, state->lineNumber);
                 return 0;
@@ -725,8 +916,7 @@ PUBLIC char *espBuildScript(HttpRoute *route, cchar *page, cchar *path, cchar *c
 #endif
 
         case ESP_TOK_LITERAL:
-            line = joinLine(token, &len);
-            mprPutToBuf(body, "  espRenderBlock(stream, \"%s\", %zd);\n", line, len);
+            mprPutToBuf(body, "%s%s%s", ESP_LITERAL_START, token, ESP_LITERAL_END);
             break;
 
         default:
@@ -758,6 +948,14 @@ PUBLIC char *espBuildScript(HttpRoute *route, cchar *page, cchar *path, cchar *c
     bodyCode = mprGetBufStart(body);
 
     if (state == &top) {
+        if (state->fragments > 0) {
+            *err = sfmt("Missing endfragment in %s", path);
+            return 0;
+        }
+        if ((bodyCode = renderLiterals(bodyCode)) == 0) {
+            *err = sfmt("Bad literal text in %s", path);
+            return 0;
+        }
         if (mprGetBufLength(state->start) > 0) {
             mprPutCharToBuf(state->start, '\n');
         }
@@ -771,7 +969,7 @@ PUBLIC char *espBuildScript(HttpRoute *route, cchar *page, cchar *path, cchar *c
             "/*\n   Generated from %s\n */\n"\
             "#include \"esp.h\"\n"\
             "%s\n"\
-            "static void %s(HttpStream *stream) {\n"\
+            "void %s(HttpStream *stream) {\n"\
             "%s%s%s"\
             "}\n\n"\
             "%s int esp_%s(HttpRoute *route) {\n"\
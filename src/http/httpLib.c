@@ -164,6 +164,9 @@ PUBLIC Http *httpCreate(int flags)
 #endif
 #if ME_HTTP_CACHE
         httpOpenCacheHandler();
+#endif
+#if ME_COM_ZLIB
+        httpOpenCompressFilter();
 #endif
         httpOpenPassHandler();
         httpOpenActionHandler();
@@ -495,6 +498,7 @@ PUBLIC void httpInitLimits(HttpLimits *limits, bool serverSide)
     limits->webSocketsFrameSize = ME_MAX_WSS_FRAME;
     limits->webSocketsPacketSize = ME_MAX_WSS_PACKET;
     limits->webSocketsPing = ME_MAX_PING_DURATION;
+    limits->webSocketsWindow = ME_MAX_WSS_WINDOW;
 #endif
 
 #if ME_HTTP_HTTP2
@@ -2217,19 +2221,36 @@ PUBLIC bool httpBasicSetHeaders(HttpStream *stream, cchar *username, cchar *pass
 
 
 
+#if ME_COM_ZLIB
+    #include    <zlib.h>
+#endif
+
 #if ME_HTTP_CACHE
 /********************************** Forwards **********************************/
 
 static void cacheAtClient(HttpStream *stream);
+static void compressCacheEntry(HttpCacheEntry *entry);
+static HttpCacheEntry *createCacheEntry(cchar *key, MprTime modified);
+static cchar *getCachedBody(HttpStream *stream, HttpCacheEntry *entry, ssize *length);
 static bool fetchCachedResponse(HttpStream *stream);
+#if ME_COM_ZLIB
+static bool isCompressible(HttpCacheEntry *entry);
+#endif
+static bool isTransientHeader(cchar *key);
 static char *makeCacheKey(HttpStream *stream);
+static void manageCacheEntry(HttpCacheEntry *entry, int flags);
 static void manageHttpCache(HttpCache *cache, int flags);
 static int matchCacheFilter(HttpStream *stream, HttpRoute *route, int dir);
 static int matchCacheHandler(HttpStream *stream, HttpRoute *route, int dir);
 static void outgoingCacheFilterService(HttpQueue *q);
+static ssize getCacheEntrySize(HttpCacheEntry *entry);
+static HttpCacheEntry *parseCachedContent(cchar *key, cchar *content, MprTime modified);
+static HttpCacheEntry *readCacheEntry(HttpStream *stream, cchar *key);
 static void readyCacheHandler(HttpQueue *q);
 static void saveCachedResponse(HttpStream *stream);
-static cchar *setHeadersFromCache(HttpStream *stream, cchar *content);
+static void setHeadersFromCache(HttpStream *stream, HttpCacheEntry *entry);
+static bool useGzip(HttpStream *stream, HttpCacheEntry *entry);
+static void writeCachedBody(HttpQueue *q, HttpCacheEntry *entry);
 
 /************************************ Code ************************************/
 
@@ -2332,15 +2353,14 @@ static void readyCacheHandler(HttpQueue *q)
 {
     HttpStream  *stream;
     HttpTx      *tx;
-    cchar       *data;
 
     stream = q->stream;
     tx = stream->tx;
 
-    if (tx->cachedContent) {
-        if ((data = setHeadersFromCache(stream, tx->cachedContent)) != 0) {
-            tx->length = slen(data);
-            httpWriteString(q, data);
+    if (tx->cachedResponse) {
+        setHeadersFromCache(stream, tx->cachedResponse);
+        if (tx->status != HTTP_CODE_NOT_MODIFIED) {
+            writeCachedBody(q, tx->cachedResponse);
         }
     }
     httpFinalize(stream);
@@ -2362,16 +2382,16 @@ static int matchCacheFilter(HttpStream *stream, HttpRoute *route, int dir)
  */
 static void outgoingCacheFilterService(HttpQueue *q)
 {
-    HttpPacket  *packet, *data;
-    HttpStream  *stream;
-    HttpTx      *tx;
-    MprKey      *kp;
-    cchar       *cachedData;
-    ssize       size;
+    HttpCacheEntry  *cached;
+    HttpPacket      *packet, *data;
+    HttpStream      *stream;
+    HttpTx          *tx;
+    cchar           *body;
+    ssize           size;
 
     stream = q->stream;
     tx = stream->tx;
-    cachedData = 0;
+    cached = 0;
 
     if (tx->status < 200 || tx->status > 299) {
         tx->cacheBuffer = 0;
@@ -2384,8 +2404,8 @@ static void outgoingCacheFilterService(HttpQueue *q)
     if (mprLookupKey(stream->tx->headers, "X-SendCache") != 0) {
         if (fetchCachedResponse(stream)) {
             httpLog(stream->trace, "cache.sendcache", "context", "msg:Using cached content");
-            cachedData = setHeadersFromCache(stream, tx->cachedContent);
-            tx->length = slen(cachedData);
+            cached = tx->cachedResponse;
+            setHeadersFromCache(stream, cached);
         }
     }
     for (packet = httpGetPacket(q); packet; packet = httpGetPacket(q)) {
@@ -2394,7 +2414,7 @@ static void outgoingCacheFilterService(HttpQueue *q)
             return;
         }
         if (packet->flags & HTTP_PACKET_DATA) {
-            if (cachedData) {
+            if (cached) {
                 /*
                     Using X-SendCache. Discard the packet.
                  */
@@ -2402,18 +2422,8 @@ static void outgoingCacheFilterService(HttpQueue *q)
 
             } else if (tx->cacheBuffer) {
                 /*
-                    Save the response packet to the cache buffer. Will write below in saveCachedResponse.
+                    Save the response body to the cache buffer. Will write below in saveCachedResponse.
                  */
-                if (mprGetBufLength(tx->cacheBuffer) == 0) {
-                    /*
-                        Add defined headers to the start of the cache buffer. Separate with a double newline.
-                     */
-                    mprPutToBuf(tx->cacheBuffer, "X-Status: %d\n", tx->status);
-                    for (kp = 0; (kp = mprGetNextKey(tx->headers, kp)) != 0; ) {
-                        mprPutToBuf(tx->cacheBuffer, "%s: %s\n", kp->key, (char*) kp->data);
-                    }
-                    mprPutCharToBuf(tx->cacheBuffer, '\n');
-                }
                 size = mprGetBufLength(packet->content);
                 if ((tx->cacheBufferLength + size) < stream->limits->cacheItemSize) {
                     mprPutBlockToBuf(tx->cacheBuffer, mprGetBufStart(packet->content), mprGetBufLength(packet->content));
@@ -2426,13 +2436,16 @@ static void outgoingCacheFilterService(HttpQueue *q)
             }
 
         } else if (packet->flags & HTTP_PACKET_END) {
-            if (cachedData) {
+            if (cached) {
                 /*
                     Using X-SendCache but there was no data packet to replace. So do the write here.
+                    The packet references the immutable cached body.
                  */
-                data = httpCreateDataPacket((ssize) tx->length);
-                mprPutBlockToBuf(data->content, cachedData, (ssize) tx->length);
-                httpPutPacketToNext(q, data);
+                body = getCachedBody(stream, cached, &size);
+                if (size > 0 && (data = httpCreateStaticPacket(body, size)) != 0) {
+                    data->data = cached;
+                    httpPutPacketToNext(q, data);
+                }
 
             } else if (tx->cacheBuffer) {
                 /*
@@ -2481,10 +2494,11 @@ static void cacheAtClient(HttpStream *stream)
  */
 static bool fetchCachedResponse(HttpStream *stream)
 {
-    HttpTx      *tx;
-    MprTime     modified, when;
-    cchar       *value, *key, *tag;
-    int         status, cacheOk, canUseClientCache;
+    HttpCacheEntry  *entry;
+    HttpTx          *tx;
+    MprTime         when;
+    cchar           *value, *key;
+    int             status, cacheOk, canUseClientCache;
 
     tx = stream->tx;
 
@@ -2496,7 +2510,7 @@ static bool fetchCachedResponse(HttpStream *stream)
             (scontains(value, "max-age=0") == 0 || scontains(value, "no-cache") == 0)) {
         httpLog(stream->trace, "cache.reload", "context", "msg:Client reload");
 
-    } else if ((tx->cachedContent = mprReadCache(stream->host->responseCache, key, &modified, 0)) != 0) {
+    } else if ((entry = readCacheEntry(stream, key)) != 0) {
         /*
             See if a NotModified response can be served. This is much faster than sending the response.
             Observe headers:
@@ -2506,26 +2520,24 @@ static bool fetchCachedResponse(HttpStream *stream)
          */
         cacheOk = 1;
         canUseClientCache = 0;
-        tag = mprGetMD5(key);
         if ((value = httpGetHeader(stream, "If-None-Match")) != 0) {
             canUseClientCache = 1;
-            if (scmp(value, tag) != 0) {
+            if (scmp(value, useGzip(stream, entry) ? entry->gzipEtag : entry->etag) != 0) {
                 cacheOk = 0;
             }
         }
         if (cacheOk && (value = httpGetHeader(stream, "If-Modified-Since")) != 0) {
             canUseClientCache = 1;
             mprParseTime(&when, value, 0, 0);
-            if (modified > when) {
+            if (entry->modified > when) {
                 cacheOk = 0;
             }
         }
         status = (canUseClientCache && cacheOk) ? HTTP_CODE_NOT_MODIFIED : HTTP_CODE_OK;
         httpLog(stream->trace, "cache.cached", "context", "msg:Use cached content, key:%s, status:%d", key, status);
         httpSetStatus(stream, status);
-        httpSetHeaderString(stream, "Etag", mprGetMD5(key));
-        httpSetHeaderString(stream, "Last-Modified", mprFormatUniversalTime(MPR_HTTP_DATE, modified));
         httpRemoveHeader(stream, "Content-Encoding");
+        tx->cachedResponse = entry;
         return 1;
     }
     httpLog(stream->trace, "cache.none", "context", "msg:No cached content, key:%s", key);
@@ -2535,52 +2547,75 @@ static bool fetchCachedResponse(HttpStream *stream)
 
 static void saveCachedResponse(HttpStream *stream)
 {
-    HttpTx      *tx;
-    MprBuf      *buf;
-    MprTime     modified;
+    HttpCacheEntry  *entry;
+    HttpTx          *tx;
+    MprBuf          *buf;
+    MprCache        *cache;
+    MprKey          *kp;
+    cchar           *key;
 
     tx = stream->tx;
     assert(tx->finalizedOutput && tx->cacheBuffer);
 
     buf = tx->cacheBuffer;
     tx->cacheBuffer = 0;
+    cache = stream->host->responseCache;
+    key = makeCacheKey(stream);
+
     /*
         Truncate modified time to get a 1 sec resolution. This is the resolution for If-Modified headers.
      */
-    modified = mprGetTime() / TPS * TPS;
-    mprWriteCache(stream->host->responseCache, makeCacheKey(stream), mprGetBufStart(buf), modified,
-        tx->cache->serverLifespan, 0, 0);
+    if ((entry = createCacheEntry(key, mprGetTime() / TPS * TPS)) == 0) {
+        return;
+    }
+    entry->status = tx->status;
+    entry->length = mprGetBufLength(buf);
+    entry->body = mprMemdup(mprGetBufStart(buf), entry->length);
+    for (ITERATE_KEYS(tx->headers, kp)) {
+        if (!isTransientHeader(kp->key)) {
+            mprAddKey(entry->headers, kp->key, kp->data);
+        }
+    }
+    compressCacheEntry(entry);
+    /*
+        The cache item data is the entity tag. The entry is linked to the item atomically and its size is included in
+        the cache memory limit.
+     */
+    mprWriteCacheWithLink(cache, key, entry->etag, entry->modified, tx->cache->serverLifespan, entry,
+        getCacheEntrySize(entry));
 }
 
 
 PUBLIC ssize httpWriteCached(HttpStream *stream)
 {
-    MprTime     modified;
-    cchar       *cacheKey, *data, *content;
+    HttpCacheEntry  *entry;
+    HttpTx          *tx;
+    cchar           *cacheKey;
 
-    if (!stream->tx->cache) {
+    tx = stream->tx;
+    if (!tx->cache) {
         return MPR_ERR_CANT_FIND;
     }
     cacheKey = makeCacheKey(stream);
-    if ((content = mprReadCache(stream->host->responseCache, cacheKey, &modified, 0)) == 0) {
+    if ((entry = readCacheEntry(stream, cacheKey)) == 0) {
         httpLog(stream->trace, "cache.none", "context", "msg:No response data in cache, key:%s", cacheKey);
         return 0;
     }
     httpLog(stream->trace, "cache.cached", "context", "msg:Used cached response, key:%s", cacheKey);
-    data = setHeadersFromCache(stream, content);
-    httpSetHeaderString(stream, "Etag", mprGetMD5(cacheKey));
-    httpSetHeaderString(stream, "Last-Modified", mprFormatUniversalTime(MPR_HTTP_DATE, modified));
-    stream->tx->cacheBuffer = 0;
-    httpWriteString(stream->writeq, data);
+    tx->cachedResponse = entry;
+    setHeadersFromCache(stream, entry);
+    tx->cacheBuffer = 0;
+    writeCachedBody(stream->writeq, entry);
     httpFinalizeOutput(stream);
-    return slen(data);
+    return entry->length;
 }
 
 
 PUBLIC ssize httpUpdateCache(HttpStream *stream, cchar *uri, cchar *data, MprTicks lifespan)
 {
-    cchar   *key;
-    ssize   len;
+    HttpCacheEntry  *entry;
+    cchar           *key;
+    ssize           len;
 
     len = slen(data);
     if (len > stream->limits->cacheItemSize) {
@@ -2594,7 +2629,14 @@ PUBLIC ssize httpUpdateCache(HttpStream *stream, cchar *uri, cchar *data, MprTic
         mprRemoveCache(stream->host->responseCache, key);
         return 0;
     }
-    return mprWriteCache(stream->host->responseCache, key, data, 0, lifespan, 0, 0);
+    /*
+        Parse the content into a cache entry now so it can be written atomically with the item as for cached responses
+     */
+    if ((entry = parseCachedContent(key, data, mprGetTime() / TPS * TPS)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    return mprWriteCacheWithLink(stream->host->responseCache, key, entry->etag, entry->modified, lifespan, entry,
+        getCacheEntrySize(entry));
 }
 
 
@@ -2716,32 +2758,265 @@ static char *makeCacheKey(HttpStream *stream)
 }
 
 
+/*
+    Read a cached response entry. Entries are written with their entity tag as the item data and are linked to the item.
+    Content written directly to the cache by other writers is of the form: headers \n\n data. This is parsed for the
+    current request only.
+ */
+static HttpCacheEntry *readCacheEntry(HttpStream *stream, cchar *key)
+{
+    HttpCacheEntry  *entry;
+    MprTime         modified;
+    cchar           *content;
+
+    if ((content = mprReadCacheWithLink(stream->host->responseCache, key, &modified, (void**) &entry)) == 0) {
+        return 0;
+    }
+    if (entry == 0 || !smatch(content, entry->etag)) {
+        entry = parseCachedContent(key, content, modified);
+    }
+    return entry;
+}
+
+
+/*
+    Memory size of a cache entry to include in the cache memory limit
+ */
+static ssize getCacheEntrySize(HttpCacheEntry *entry)
+{
+    MprKey      *kp;
+    ssize       size;
+
+    size = entry->length + entry->gzipLength;
+    for (ITERATE_KEYS(entry->headers, kp)) {
+        size += slen(kp->key) + slen(kp->data);
+    }
+    return size;
+}
+
+
+static HttpCacheEntry *createCacheEntry(cchar *key, MprTime modified)
+{
+    HttpCacheEntry  *entry;
+
+    if ((entry = mprAllocObj(HttpCacheEntry, manageCacheEntry)) == 0) {
+        return 0;
+    }
+    entry->headers = mprCreateHash(HTTP_SMALL_HASH_SIZE, MPR_HASH_CASELESS | MPR_HASH_STABLE);
+    entry->status = HTTP_CODE_OK;
+    entry->modified = modified;
+    entry->etag = mprGetMD5(sfmt("%s:%lld", key, modified));
+    entry->lastModified = mprFormatUniversalTime(MPR_HTTP_DATE, modified);
+    return entry;
+}
+
+
+static void manageCacheEntry(HttpCacheEntry *entry, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(entry->headers);
+        mprMark(entry->etag);
+        mprMark(entry->lastModified);
+        mprMark(entry->body);
+        mprMark(entry->gzip);
+        mprMark(entry->gzipEtag);
+    }
+}
+
+
 /*
     Parse cached content of the form:  headers \n\n data
-    Set headers in the current request and return a reference to the data portion
  */
-static cchar *setHeadersFromCache(HttpStream *stream, cchar *content)
+static HttpCacheEntry *parseCachedContent(cchar *key, cchar *content, MprTime modified)
 {
-    cchar   *data;
-    char    *header, *headers, *key, *value, *tok;
+    HttpCacheEntry  *entry;
+    cchar           *data;
+    char            *header, *headers, *name, *value, *tok;
 
+    if ((entry = createCacheEntry(key, modified)) == 0) {
+        return 0;
+    }
     if ((data = strstr(content, "\n\n")) == 0) {
         data = content;
     } else {
         headers = snclone(content, data - content);
         data += 2;
         for (header = stok(headers, "\n", &tok); header; header = stok(NULL, "\n", &tok)) {
-            key = ssplit(header, ": ", &value);
-            if (smatch(key, "X-Status")) {
-                stream->tx->status = (int) stoi(value);
+            name = ssplit(header, ": ", &value);
+            if (smatch(name, "X-Status")) {
+                entry->status = (int) stoi(value);
             } else {
-                httpAddHeaderString(stream, key, value);
+                mprAddKey(entry->headers, name, sclone(value));
             }
         }
     }
-    return data;
+    entry->length = slen(data);
+    entry->body = snclone(data, entry->length);
+    compressCacheEntry(entry);
+    return entry;
 }
 
+
+/*
+    Headers that describe a single transmission of the response and are recomputed for each response
+ */
+static bool isTransientHeader(cchar *key)
+{
+    return scaselessmatch(key, "Date") || scaselessmatch(key, "Content-Length") ||
+        scaselessmatch(key, "Transfer-Encoding") || scaselessmatch(key, "Etag") ||
+        scaselessmatch(key, "Last-Modified") || scaselessmatch(key, "Connection") ||
+        scaselessmatch(key, "Keep-Alive");
+}
+
+
+/*
+    Set the response status and headers from a cache entry. The entry is immutable so header values are referenced
+    rather than copied. A Not-Modified status is preserved.
+ */
+static void setHeadersFromCache(HttpStream *stream, HttpCacheEntry *entry)
+{
+    HttpTx      *tx;
+    MprKey      *kp;
+
+    tx = stream->tx;
+    if (tx->status != HTTP_CODE_NOT_MODIFIED) {
+        tx->status = entry->status;
+    }
+    for (ITERATE_KEYS(entry->headers, kp)) {
+        if (!mprLookupKey(tx->headers, kp->key)) {
+            mprAddKey(tx->headers, kp->key, kp->data);
+        }
+    }
+    if (useGzip(stream, entry)) {
+        httpSetHeaderString(stream, "Content-Encoding", "gzip");
+        mprAddKey(tx->headers, "Etag", entry->gzipEtag);
+    } else {
+        mprAddKey(tx->headers, "Etag", entry->etag);
+    }
+    mprAddKey(tx->headers, "Last-Modified", entry->lastModified);
+}
+
+
+/*
+    Write the cached body by reference. The packets retain the entry so the body remains valid even if the
+    entry is removed from the cache while the response is being sent.
+ */
+static void writeCachedBody(HttpQueue *q, HttpCacheEntry *entry)
+{
+    HttpPacket  *packet;
+    cchar       *body;
+    ssize       len, thisWrite;
+
+    body = getCachedBody(q->stream, entry, &len);
+    q->stream->tx->length = len;
+    q->stream->tx->responded = 1;
+    for (; len > 0; body += thisWrite, len -= thisWrite) {
+        thisWrite = min(len, q->packetSize);
+        if ((packet = httpCreateStaticPacket(body, thisWrite)) == 0) {
+            return;
+        }
+        packet->data = entry;
+        httpPutPacket(q, packet);
+    }
+}
+
+/*
+    Get the cached body encoding to send and set the transmission length
+ */
+static cchar *getCachedBody(HttpStream *stream, HttpCacheEntry *entry, ssize *length)
+{
+    if (useGzip(stream, entry)) {
+        stream->tx->length = *length = entry->gzipLength;
+        return entry->gzip;
+    }
+    stream->tx->length = *length = entry->length;
+    return entry->body;
+}
+
+
+/*
+    Use the gzip encoding if present and accepted by the client
+ */
+static bool useGzip(HttpStream *stream, HttpCacheEntry *entry)
+{
+    return entry->gzip && httpAcceptsEncoding(stream, "gzip");
+}
+
+
+/*
+    Store a gzip encoding of the body with the entry. This is done once when the entry is created so cache hits
+    from gzip-capable clients are compressed without any per-request cost.
+ */
+static void compressCacheEntry(HttpCacheEntry *entry)
+{
+#if ME_COM_ZLIB
+    z_stream    zs;
+    cchar       *vary;
+    char        *gzip;
+    ssize       size;
+    int         rc;
+
+    if (!isCompressible(entry)) {
+        return;
+    }
+    memset(&zs, 0, sizeof(zs));
+    /* Window bits of 15 + 16 select the gzip wrapper */
+    if (deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return;
+    }
+    size = (ssize) deflateBound(&zs, (uLong) entry->length);
+    if ((gzip = mprAlloc(size)) == 0) {
+        deflateEnd(&zs);
+        return;
+    }
+    zs.next_in = (Bytef*) entry->body;
+    zs.avail_in = (uInt) entry->length;
+    zs.next_out = (Bytef*) gzip;
+    zs.avail_out = (uInt) size;
+    rc = deflate(&zs, Z_FINISH);
+    size = (ssize) zs.total_out;
+    deflateEnd(&zs);
+
+    if (rc != Z_STREAM_END || size >= entry->length) {
+        return;
+    }
+    entry->gzip = mprRealloc(gzip, size);
+    entry->gzipLength = size;
+    entry->gzipEtag = sfmt("%s-gzip", entry->etag);
+
+    if ((vary = mprLookupKey(entry->headers, "Vary")) == 0) {
+        mprAddKey(entry->headers, "Vary", sclone("Accept-Encoding"));
+    } else if (!scaselesscontains(vary, "Accept-Encoding")) {
+        mprAddKey(entry->headers, "Vary", sjoin(vary, ", Accept-Encoding", NULL));
+    }
+#endif
+}
+
+
+#if ME_COM_ZLIB
+/*
+    Test if the body is worth compressing. Already encoded bodies and compressed media types are not compressed.
+ */
+static bool isCompressible(HttpCacheEntry *entry)
+{
+    cchar   *type;
+
+    if (entry->length < ME_HTTP_COMPRESS_MIN || mprLookupKey(entry->headers, "Content-Encoding")) {
+        return 0;
+    }
+    if ((type = mprLookupKey(entry->headers, "Content-Type")) == 0) {
+        return 1;
+    }
+    if (sstarts(type, "image/")) {
+        return sstarts(type, "image/svg");
+    }
+    if (sstarts(type, "audio/") || sstarts(type, "video/") || sstarts(type, "font/woff")) {
+        return 0;
+    }
+    return !(scontains(type, "zip") || scontains(type, "compress") || scontains(type, "octet-stream"));
+}
+#endif /* ME_COM_ZLIB */
+
 #endif /* ME_HTTP_CACHE */
 
 /*
@@ -3650,6 +3925,340 @@ PUBLIC int httpWait(HttpStream *stream, int state, MprTicks timeout)
 }
 
 
+/*
+    Copyright (c) Embedthis Software. All Rights Reserved.
+    This software is distributed under a commercial license. Consult the LICENSE.md
+    distributed with this software for full details and copyrights.
+ */
+
+
+/********* Start of file src/compressFilter.c ************/
+
+/*
+    compressFilter.c - Dynamic response compression filter.
+
+    This is an output only filter that compresses response content using gzip or deflate content encoding.
+    Content is compressed packet by packet as it is generated so the response is never buffered in full.
+
+    Copyright (c) All Rights Reserved. See details at the end of the file.
+ */
+
+/********************************* Includes ***********************************/
+
+
+
+#if ME_COM_ZLIB
+    #include    <zlib.h>
+
+/*********************************** Locals ***********************************/
+
+typedef struct Compress {
+    z_stream    zs;                 /* Zlib stream state */
+    HttpPacket  *packet;            /* Partially filled output packet */
+    int         active;             /* Zlib stream is initialized */
+    int         pending;            /* Data has been compressed since the last flush */
+} Compress;
+
+/********************************** Forwards **********************************/
+
+static bool compressible(HttpQueue *q, HttpCompress *compress);
+static int compressData(HttpQueue *q, cchar *data, ssize len, int flush);
+static bool isTextType(cchar *type);
+static void manageCompress(Compress *cp, int flags);
+static void manageHttpCompress(HttpCompress *compress, int flags);
+static int matchCompress(HttpStream *stream, HttpRoute *route, int dir);
+static void outgoingCompressService(HttpQueue *q);
+static bool startCompress(HttpQueue *q);
+
+/*********************************** Code *************************************/
+
+PUBLIC int httpOpenCompressFilter()
+{
+    HttpStage     *filter;
+
+    if ((filter = httpCreateFilter("compressFilter", NULL)) == 0) {
+        return MPR_ERR_CANT_CREATE;
+    }
+    HTTP->compressFilter = filter;
+    filter->match = matchCompress;
+    filter->outgoingService = outgoingCompressService;
+    return 0;
+}
+
+
+static int matchCompress(HttpStream *stream, HttpRoute *route, int dir)
+{
+    if ((dir & HTTP_STAGE_TX) && route->compress && !(stream->rx->flags & HTTP_HEAD) &&
+            (httpAcceptsEncoding(stream, "gzip") || httpAcceptsEncoding(stream, "deflate"))) {
+        return HTTP_ROUTE_OK;
+    }
+    return HTTP_ROUTE_OMIT_FILTER;
+}
+
+
+static void outgoingCompressService(HttpQueue *q)
+{
+    Compress    *cp;
+    HttpPacket  *packet;
+    HttpStream  *stream;
+
+    stream = q->stream;
+
+    /*
+        Decide when the first packet arrives as the response status and headers are then defined
+     */
+    if (!q->queueData && !startCompress(q)) {
+        httpTransferPackets(q, q->nextQ);
+        httpRemoveQueue(q);
+        if (httpShouldTrace(stream->trace, "detail")) {
+            httpLogProc(stream->trace, "tx.compress", "detail", 0, "msg:remove compress filter");
+        }
+        httpTraceQueues(stream);
+        return;
+    }
+    cp = q->queueData;
+    for (packet = httpGetPacket(q); packet; packet = httpGetPacket(q)) {
+        if (!httpWillNextQueueAcceptPacket(q, packet)) {
+            httpPutBackPacket(q, packet);
+            return;
+        }
+        if (packet->flags & HTTP_PACKET_DATA) {
+            if (compressData(q, mprGetBufStart(packet->content), httpGetPacketLength(packet), Z_NO_FLUSH) < 0) {
+                return;
+            }
+            cp->pending = 1;
+
+        } else if (packet->flags & HTTP_PACKET_END) {
+            if (compressData(q, NULL, 0, Z_FINISH) < 0) {
+                return;
+            }
+            cp->pending = 0;
+            httpPutPacketToNext(q, packet);
+
+        } else {
+            httpPutPacketToNext(q, packet);
+        }
+    }
+    if (stream->tx->flush) {
+        /*
+            Output was explicitly flushed. Emit the compressed output so it is not held back waiting for more data.
+         */
+        if (cp->pending && compressData(q, NULL, 0, Z_SYNC_FLUSH) == 0) {
+            cp->pending = 0;
+        }
+        stream->tx->flush = 0;
+    }
+}
+
+
+static bool startCompress(HttpQueue *q)
+{
+    HttpStream  *stream;
+    HttpTx      *tx;
+    Compress    *cp;
+    cchar       *encoding, *vary;
+    int         bits;
+
+    stream = q->stream;
+    tx = stream->tx;
+
+    if (!compressible(q, stream->rx->route->compress)) {
+        return 0;
+    }
+    /* Window bits of 15 + 16 select the gzip wrapper. Deflate uses the zlib wrapper (RFC 9110). */
+    if (httpAcceptsEncoding(stream, "gzip")) {
+        encoding = "gzip";
+        bits = 15 + 16;
+    } else {
+        encoding = "deflate";
+        bits = 15;
+    }
+    if ((cp = mprAllocObj(Compress, manageCompress)) == 0) {
+        return 0;
+    }
+    if (deflateInit2(&cp->zs, stream->rx->route->compress->level, Z_DEFLATED, bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 0;
+    }
+    cp->active = 1;
+    q->queueData = cp;
+
+    /*
+        The compressed length is not known so the chunk filter will determine the transfer length
+     */
+    httpSetHeaderString(stream, "Content-Encoding", encoding);
+    httpRemoveHeader(stream, "Content-Length");
+    tx->length = -1;
+    if (tx->etag) {
+        tx->etag = sfmt("%s-%s", tx->etag, encoding);
+    }
+    if ((vary = mprLookupKey(tx->headers, "Vary")) == 0) {
+        httpSetHeaderString(stream, "Vary", "Accept-Encoding");
+    } else if (!scaselesscontains(vary, "Accept-Encoding")) {
+        httpAppendHeaderString(stream, "Vary", "Accept-Encoding");
+    }
+    if (httpShouldTrace(stream->trace, "context")) {
+        httpLogProc(stream->trace, "tx.compress", "context", 0, "encoding:%s", encoding);
+    }
+    return 1;
+}
+
+
+/*
+    Test if the response should be compressed
+ */
+static bool compressible(HttpQueue *q, HttpCompress *compress)
+{
+    HttpStream  *stream;
+    HttpTx      *tx;
+    cchar       *type;
+    char        *cp, *mimeType;
+    ssize       size;
+
+    stream = q->stream;
+    tx = stream->tx;
+
+    /*
+        Responses being captured by the cache are not compressed as the cache stores its own gzip encoding.
+        HTTP/1.0 responses are not compressed as the compressed length cannot be sent without chunking.
+     */
+    if (!compress || tx->status != HTTP_CODE_OK || tx->outputRanges || tx->cacheBuffer || stream->upgraded ||
+            stream->net->protocol < 1) {
+        return 0;
+    }
+    if (mprLookupKey(tx->headers, "Content-Encoding") || (q->first && q->first->esize > 0)) {
+        return 0;
+    }
+    size = (tx->length >= 0) ? (ssize) tx->length : (tx->finalizedOutput ? q->count : -1);
+    if (0 <= size && size < compress->minSize) {
+        return 0;
+    }
+    if ((type = mprLookupKey(tx->headers, "Content-Type")) == 0 && (type = tx->mimeType) == 0 &&
+            (type = mprLookupMime(stream->rx->route->mimeTypes, tx->ext)) == 0) {
+        type = "text/html";
+    }
+    mimeType = slower(type);
+    if ((cp = schr(mimeType, ';')) != 0) {
+        *cp = '\0';
+    }
+    mimeType = strim(mimeType, " \t", MPR_TRIM_BOTH);
+    if (compress->types) {
+        return mprLookupKey(compress->types, mimeType) || mprLookupKey(compress->types, "*");
+    }
+    return isTextType(mimeType);
+}
+
+
+/*
+    Default compressible types: text, JSON, XML, JavaScript and SVG. Event streams are not compressed.
+ */
+static bool isTextType(cchar *type)
+{
+    if (sstarts(type, "text/")) {
+        return !smatch(type, "text/event-stream");
+    }
+    return smatch(type, "application/json") || smatch(type, "application/javascript") ||
+        smatch(type, "application/xml") || smatch(type, "image/svg+xml") ||
+        sends(type, "+json") || sends(type, "+xml");
+}
+
+
+/*
+    Compress data into output packets. Full packets are sent downstream. A partially filled packet is retained for
+    more output unless flushing.
+ */
+static int compressData(HttpQueue *q, cchar *data, ssize len, int flush)
+{
+    Compress    *cp;
+    MprBuf      *buf;
+    ssize       space;
+    int         rc;
+
+    cp = q->queueData;
+    cp->zs.next_in = (Bytef*) data;
+    cp->zs.avail_in = (uInt) len;
+    do {
+        if (!cp->packet && (cp->packet = httpCreateDataPacket(q->packetSize)) == 0) {
+            return MPR_ERR_MEMORY;
+        }
+        buf = cp->packet->content;
+        space = mprGetBufSpace(buf);
+        cp->zs.next_out = (Bytef*) mprGetBufEnd(buf);
+        cp->zs.avail_out = (uInt) space;
+        if ((rc = deflate(&cp->zs, flush)) == Z_STREAM_ERROR) {
+            httpError(q->stream, HTTP_CODE_INTERNAL_SERVER_ERROR, "Cannot compress response");
+            return MPR_ERR_BAD_STATE;
+        }
+        mprAdjustBufEnd(buf, space - (ssize) cp->zs.avail_out);
+        if (mprGetBufSpace(buf) == 0 || (flush != Z_NO_FLUSH && cp->zs.avail_out > 0)) {
+            if (httpGetPacketLength(cp->packet) > 0) {
+                httpPutPacketToNext(q, cp->packet);
+            }
+            cp->packet = 0;
+        }
+    } while (cp->zs.avail_out == 0 || (flush == Z_FINISH && rc != Z_STREAM_END));
+    return 0;
+}
+
+
+static void manageCompress(Compress *cp, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(cp->packet);
+
+    } else if (flags & MPR_MANAGE_FREE) {
+        if (cp->active) {
+            deflateEnd(&cp->zs);
+        }
+    }
+}
+
+
+static void manageHttpCompress(HttpCompress *compress, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(compress->types);
+    }
+}
+#endif /* ME_COM_ZLIB */
+
+
+PUBLIC int httpSetRouteCompress(HttpRoute *route, int level, ssize minSize, cchar *types)
+{
+#if ME_COM_ZLIB
+    HttpCompress    *compress;
+    HttpStage       *stage;
+    char            *item, *tok;
+    int             next;
+
+    assert(route);
+
+    if (level <= 0) {
+        route->compress = 0;
+        return 0;
+    }
+    if ((compress = mprAllocObj(HttpCompress, manageHttpCompress)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    compress->level = min(level, Z_BEST_COMPRESSION);
+    compress->minSize = (minSize >= 0) ? minSize : ME_HTTP_COMPRESS_MIN;
+    if (types && *types) {
+        compress->types = mprCreateHash(0, MPR_HASH_CASELESS | MPR_HASH_STABLE);
+        for (item = stok(sclone(types), " \t,", &tok); item; item = stok(0, " \t,", &tok)) {
+            mprAddKey(compress->types, item, compress);
+        }
+    }
+    route->compress = compress;
+    for (ITERATE_ITEMS(route->outputStages, stage, next)) {
+        if (smatch(stage->name, "compressFilter")) {
+            return 0;
+        }
+    }
+    return httpAddRouteFilter(route, "compressFilter", "", HTTP_STAGE_TX);
+#else
+    return MPR_ERR_BAD_STATE;
+#endif
+}
+
 /*
     Copyright (c) Embedthis Software. All Rights Reserved.
     This software is distributed under a commercial license. Consult the LICENSE.md
@@ -4263,12 +4872,30 @@ static void parseCharset(HttpRoute *route, cchar *key, MprJson *prop)
 }
 
 
+/*
+    compress: true | [extensions]
+    compress: { level: 6, minimum: '1k', mime: ['text/html', 'application/json'], static: true }
+
+    The first form serves pre-compressed and minified static files. The object form compresses responses dynamically.
+ */
 static void parseCompress(HttpRoute *route, cchar *key, MprJson *prop)
 {
+    cchar   *level, *minimum;
+
     if (smatch(prop->value, "true")) {
         httpAddRouteMapping(route, "", "${1}.gz, min.${1}.gz, min.${1}");
     } else if (prop->type & MPR_JSON_ARRAY) {
         httpAddRouteMapping(route, mprJsonToString(prop, 0), "${1}.gz, min.${1}.gz, min.${1}");
+    } else if (prop->type & MPR_JSON_OBJ) {
+        level = mprReadJson(prop, "level");
+        minimum = mprReadJson(prop, "minimum");
+        if (httpSetRouteCompress(route, level ? (int) stoi(level) : 6, minimum ? (ssize) httpGetNumber(minimum) : -1,
+                getList(mprReadJsonObj(prop, "mime"))) < 0) {
+            mprLog("warn http config", 1, "Dynamic compression not built in binary. Ignoring compress configuration");
+        }
+        if (smatch(mprReadJson(prop, "static"), "true")) {
+            httpAddRouteMapping(route, "", "${1}.gz, min.${1}.gz, min.${1}");
+        }
     }
 }
 
@@ -4650,6 +5277,18 @@ static void parseLimitsWebSocketsPacket(HttpRoute *route, cchar *key, MprJson *p
 {
     route->limits->webSocketsPacketSize = httpGetInt(prop->value);
 }
+
+
+/*
+    Window size in bits for permessage-deflate. Zlib does not support raw deflate with a window smaller than 9 bits.
+ */
+static void parseLimitsWebSocketsWindow(HttpRoute *route, cchar *key, MprJson *prop)
+{
+    int     bits;
+
+    bits = httpGetInt(prop->value);
+    route->limits->webSocketsWindow = max(min(bits, 15), 9);
+}
 #endif
 
 
@@ -5528,6 +6167,18 @@ static void parseTrace(HttpRoute *route, cchar *key, MprJson *prop)
 }
 
 
+static void parseWebSocketsDeflate(HttpRoute *route, cchar *key, MprJson *prop)
+{
+#if ME_COM_ZLIB
+    httpSetRouteWebSocketsDeflate(route, (prop->type & MPR_JSON_TRUE) ? 1 : 0);
+#else
+    if (prop->type & MPR_JSON_TRUE) {
+        mprLog("warn http config", 1, "WebSockets deflate not built in binary. Ignoring websockets deflate configuration");
+    }
+#endif
+}
+
+
 static void parseWebSocketsProtocol(HttpRoute *route, cchar *key, MprJson *prop)
 {
     route->webSocketsProtocol = sclone(prop->value);
@@ -5727,6 +6378,8 @@ PUBLIC int httpInitParser()
     httpAddConfig("http.timeouts.request", parseTimeoutsRequest);
     httpAddConfig("http.timeouts.session", parseTimeoutsSession);
     httpAddConfig("http.trace", parseTrace);
+    httpAddConfig("http.websockets", httpParseAll);
+    httpAddConfig("http.websockets.deflate", parseWebSocketsDeflate);
     httpAddConfig("http.websockets.protocol", parseWebSocketsProtocol);
     httpAddConfig("http.xsrf", parseXsrf);
 
@@ -5744,6 +6397,7 @@ PUBLIC int httpInitParser()
     httpAddConfig("http.limits.webSocketsMessage", parseLimitsWebSocketsMessage);
     httpAddConfig("http.limits.webSocketsPacket", parseLimitsWebSocketsPacket);
     httpAddConfig("http.limits.webSocketsFrame", parseLimitsWebSocketsFrame);
+    httpAddConfig("http.limits.webSocketsWindow", parseLimitsWebSocketsWindow);
 #endif
 
 #if DEPRECATED
@@ -15211,6 +15865,21 @@ PUBLIC HttpPacket *httpCreateDataPacket(ssize size)
 }
 
 
+PUBLIC HttpPacket *httpCreateStaticPacket(cchar *data, ssize size)
+{
+    HttpPacket    *packet;
+
+    if ((packet = httpCreatePacket(0)) == 0) {
+        return 0;
+    }
+    if ((packet->content = mprCreateStaticBuf(data, size)) == 0) {
+        return 0;
+    }
+    packet->flags = HTTP_PACKET_DATA;
+    return packet;
+}
+
+
 PUBLIC HttpPacket *httpCreateEntityPacket(MprOff pos, MprOff size, HttpFillProc fill)
 {
     HttpPacket    *packet;
@@ -15444,6 +16113,10 @@ PUBLIC void httpJoinPackets(HttpQueue *q, ssize size)
         npackets = count = 0;
         for (p = q->first; p; p = p->next) {
             if (!(p->flags & (HTTP_PACKET_HEADER | HTTP_PACKET_END))) {
+                if (p->content && (p->content->flags & MPR_BUF_STATIC)) {
+                    /* Don't copy static data. Packets between static packets are already filled by httpWriteBlock */
+                    return;
+                }
                 count += httpGetPacketLength(p);
                 npackets++;
             }
@@ -15646,6 +16319,10 @@ PUBLIC HttpPacket *httpSplitPacket(HttpPacket *orig, ssize offset)
                 return 0;
             }
             tail->content = orig->content;
+            if (tail->content->flags & MPR_BUF_STATIC) {
+                /* Retain any managed owner of the static content */
+                tail->data = orig->data;
+            }
             if ((orig->content = mprCreateBuf(offset, 0)) == 0) {
                 return 0;
             }
@@ -17388,6 +18065,7 @@ PUBLIC cchar *httpTraceHeaders(MprHash *headers)
 
 /********************************** Forwards **********************************/
 
+static void flushFilters(HttpStream *stream);
 static void initQueue(HttpNet *net, HttpStream *stream, HttpQueue *q, cchar *name, int dir, int flags);
 static void manageQueue(HttpQueue *q, int flags);
 
@@ -17679,6 +18357,7 @@ PUBLIC bool httpFlushQueue(HttpQueue *q, int flags)
 
 PUBLIC void httpFlush(HttpStream *stream)
 {
+    flushFilters(stream);
     httpFlushQueue(stream->writeq, HTTP_NON_BLOCK);
 }
 
@@ -17688,10 +18367,30 @@ PUBLIC void httpFlush(HttpStream *stream)
  */
 PUBLIC void httpFlushAll(HttpStream *stream)
 {
+    flushFilters(stream);
     httpFlushQueue(stream->writeq, stream->net->async ? HTTP_NON_BLOCK : HTTP_BLOCK);
 }
 
 
+/*
+    Ask filters that buffer output, such as the compress filter, to emit it. The filter queues are scheduled after
+    the write queue so they are serviced with any data it passes on, even if no new data has been written.
+ */
+static void flushFilters(HttpStream *stream)
+{
+    HttpQueue   *q;
+
+    if (!stream->tx || !stream->writeq) {
+        return;
+    }
+    stream->tx->flush = 1;
+    httpScheduleQueue(stream->writeq);
+    for (q = stream->writeq->nextQ; q != stream->txHead && q != stream->writeq; q = q->nextQ) {
+        httpScheduleQueue(q);
+    }
+}
+
+
 PUBLIC bool httpResumeQueue(HttpQueue *q, bool schedule)
 {
     HttpQueue   *prevQ;
@@ -18520,6 +19219,7 @@ PUBLIC HttpRoute *httpCreateInheritedRoute(HttpRoute *parent)
     route->autoFinalize = parent->autoFinalize;
     route->caching = parent->caching;
     route->canonical = parent->canonical;
+    route->compress = parent->compress;
     route->charSet = parent->charSet;
     route->clientConfig = parent->clientConfig;
     route->conditions = parent->conditions;
@@ -18591,6 +19291,7 @@ static void manageRoute(HttpRoute *route, int flags)
     if (flags & MPR_MANAGE_MARK) {
         mprMark(route->auth);
         mprMark(route->caching);
+        mprMark(route->compress);
         mprMark(route->canonical);
         mprMark(route->charSet);
         mprMark(route->clientConfig);
@@ -19979,6 +20680,15 @@ PUBLIC void httpSetRouteUploadDir(HttpRoute *route, cchar *dir)
 }
 
 
+PUBLIC void httpSetRouteWebSocketsDeflate(HttpRoute *route, bool on)
+{
+    route->flags &= ~HTTP_ROUTE_WEB_SOCKETS_DEFLATE;
+    if (on) {
+        route->flags |= HTTP_ROUTE_WEB_SOCKETS_DEFLATE;
+    }
+}
+
+
 #if DEPRECATED
 PUBLIC void httpSetRouteWorkers(HttpRoute *route, int workers)
 {
@@ -22092,6 +22802,51 @@ PUBLIC cchar *httpGetCookie(HttpStream *stream, cchar *name)
 }
 
 
+/*
+    Parse the Accept-Encoding header of the form: "gzip, deflate;q=0.5, *;q=0"
+    A named encoding takes precedence over the "*" wildcard.
+ */
+PUBLIC bool httpAcceptsEncoding(HttpStream *stream, cchar *encoding)
+{
+    cchar   *cp, *end, *quality;
+    ssize   len, nlen;
+    int     accept, wild;
+
+    if (stream->rx == 0 || (cp = stream->rx->acceptEncoding) == 0 || !encoding) {
+        return 0;
+    }
+    len = slen(encoding);
+    wild = -1;
+    while (*cp) {
+        while (*cp == ' ' || *cp == '\t' || *cp == ',') {
+            cp++;
+        }
+        if ((end = schr(cp, ',')) == 0) {
+            end = &cp[slen(cp)];
+        }
+        for (nlen = 0; &cp[nlen] < end && cp[nlen] != ';' && cp[nlen] != ' ' && cp[nlen] != '\t'; nlen++) ;
+        if (nlen > 0) {
+            accept = 1;
+            if ((quality = sncontains(cp, "q=", end - cp)) != 0) {
+                /* Quality values of "0", "0.0" etc. disable the encoding */
+                for (quality += 2; quality < end && (*quality == '0' || *quality == '.'); quality++) ;
+                if (quality == end || *quality == ' ' || *quality == '\t' || *quality == ';') {
+                    accept = 0;
+                }
+            }
+            if (nlen == len && sncaselesscmp(cp, encoding, len) == 0) {
+                return accept;
+            }
+            if (nlen == 1 && *cp == '*') {
+                wild = accept;
+            }
+        }
+        cp = end;
+    }
+    return wild > 0;
+}
+
+
 PUBLIC cchar *httpGetHeader(HttpStream *stream, cchar *key)
 {
     if (stream->rx == 0) {
@@ -25025,7 +25780,7 @@ static void manageTx(HttpTx *tx, int flags)
         mprMark(tx->altBody);
         mprMark(tx->cache);
         mprMark(tx->cacheBuffer);
-        mprMark(tx->cachedContent);
+        mprMark(tx->cachedResponse);
         mprMark(tx->charSet);
         mprMark(tx->stream);
         mprMark(tx->connector);
@@ -25906,29 +26661,48 @@ PUBLIC ssize httpWriteBlock(HttpQueue *q, cchar *buf, ssize len, int flags)
         if (stream->state >= HTTP_STATE_FINALIZED || stream->net->error) {
             return MPR_ERR_CANT_WRITE;
         }
-        if (q->last && (q->last != q->first) && (q->last->flags & HTTP_PACKET_DATA) && mprGetBufSpace(q->last->content) > 0) {
-            packet = q->last;
-        } else {
-            packetSize = (tx->chunkSize > 0) ? tx->chunkSize : q->packetSize;
-            if ((packet = httpCreateDataPacket(packetSize)) == 0) {
-                return MPR_ERR_MEMORY;
+        packetSize = (tx->chunkSize > 0) ? tx->chunkSize : q->packetSize;
+        if ((flags & HTTP_STATIC) && len >= ME_STATIC_PACKET_MIN) {
+            /*
+                Queue a reference to the static data rather than copying
+             */
+            thisWrite = min(len, packetSize);
+            if (flags & (HTTP_BLOCK | HTTP_NON_BLOCK) && q->count < q->max) {
+                thisWrite = min(thisWrite, q->max - q->count);
             }
-        }
-        thisWrite = min(len, mprGetBufSpace(packet->content));
-        if (flags & (HTTP_BLOCK | HTTP_NON_BLOCK) && q->count < q->max) {
-            thisWrite = min(thisWrite, q->max - q->count);
-        }
-        if (thisWrite > 0) {
-            if ((thisWrite = mprPutBlockToBuf(packet->content, buf, thisWrite)) == 0) {
+            if ((packet = httpCreateStaticPacket(buf, thisWrite)) == 0) {
                 return MPR_ERR_MEMORY;
             }
             buf += thisWrite;
             len -= thisWrite;
             totalWritten += thisWrite;
-            if (packet == q->last) {
-                q->count += thisWrite;
+            httpPutPacket(q, packet);
+
+        } else {
+            if (q->last && (q->last != q->first) && (q->last->flags & HTTP_PACKET_DATA) &&
+                    mprGetBufSpace(q->last->content) > 0) {
+                packet = q->last;
             } else {
-                httpPutPacket(q, packet);
+                if ((packet = httpCreateDataPacket(packetSize)) == 0) {
+                    return MPR_ERR_MEMORY;
+                }
+            }
+            thisWrite = min(len, mprGetBufSpace(packet->content));
+            if (flags & (HTTP_BLOCK | HTTP_NON_BLOCK) && q->count < q->max) {
+                thisWrite = min(thisWrite, q->max - q->count);
+            }
+            if (thisWrite > 0) {
+                if ((thisWrite = mprPutBlockToBuf(packet->content, buf, thisWrite)) == 0) {
+                    return MPR_ERR_MEMORY;
+                }
+                buf += thisWrite;
+                len -= thisWrite;
+                totalWritten += thisWrite;
+                if (packet == q->last) {
+                    q->count += thisWrite;
+                } else {
+                    httpPutPacket(q, packet);
+                }
             }
         }
         if (!flushPipe(q, flags) && flags & HTTP_NON_BLOCK) {
@@ -25964,21 +26738,63 @@ PUBLIC ssize httpWriteString(HttpQueue *q, cchar *s)
 }
 
 
+/*
+    Write a string with HTML escaping. The leading run of characters that need no escaping is written directly into the
+    queue without creating a copy. The remainder is escaped by mprEscapeHtml so the output is identical.
+    The scan set includes every character mprEscapeHtml may escape. strcspn is vectorized by most C libraries.
+ */
 PUBLIC ssize httpWriteSafeString(HttpQueue *q, cchar *s)
 {
-    return httpWriteString(q, mprEscapeHtml(s));
+    ssize   len, nbytes, written;
+
+    if (s == 0) {
+        return 0;
+    }
+    written = 0;
+    if ((len = strcspn(s, "&<>#()\"'")) > 0) {
+        if ((written = httpWriteBlock(q, s, len, HTTP_BUFFER)) < 0) {
+            return written;
+        }
+        s += len;
+    }
+    if (*s) {
+        if ((nbytes = httpWriteString(q, mprEscapeHtml(s))) < 0) {
+            return nbytes;
+        }
+        written += nbytes;
+    }
+    return written;
 }
 
 
 PUBLIC ssize httpWrite(HttpQueue *q, cchar *fmt, ...)
 {
     va_list     vargs;
-    char        *buf;
+    ssize       len;
 
     va_start(vargs, fmt);
-    buf = sfmtv(fmt, vargs);
+    len = httpWritev(q, fmt, vargs);
     va_end(vargs);
-    return httpWriteString(q, buf);
+    return len;
+}
+
+
+/*
+    Format into a stack buffer and write via httpWriteBlock. Only output too large for the buffer is allocated.
+ */
+PUBLIC ssize httpWritev(HttpQueue *q, cchar *fmt, va_list args)
+{
+    va_list     ap;
+    char        buf[ME_BUFSIZE];
+    ssize       len;
+
+    va_copy(ap, args);
+    fmtv(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if ((len = slen(buf)) < (ssize) sizeof(buf) - 1) {
+        return httpWriteBlock(q, buf, len, HTTP_BUFFER);
+    }
+    return httpWriteString(q, sfmtv(fmt, args));
 }
 
 /*
@@ -28339,6 +29155,9 @@ PUBLIC bool httpMatchParam(HttpStream *stream, cchar *var, cchar *value)
 
 
 #if ME_HTTP_WEB_SOCKETS
+#if ME_COM_ZLIB
+    #include    <zlib.h>
+#endif
 /********************************** Locals ************************************/
 /*
     Message frame states
@@ -28394,10 +29213,40 @@ static char *codetxt[16] = {
 #define GET_LEN(v)              ((v) & 0x7f)                /* Low order 7 bits of length */
 
 #define SET_FIN(v)              (((v) & 0x1) << 7)
+#define SET_RSV1(v)             (((v) & 0x1) << 6)
 #define SET_MASK(v)             (((v) & 0x1) << 7)
 #define SET_CODE(v)             ((v) & 0xf)
 #define SET_LEN(len, n)         ((uchar)(((len) >> ((n) * 8)) & 0xff))
 
+#define WS_RSV1                 0x4                         /* GET_RSV bit for a permessage-deflate message */
+
+#if ME_COM_ZLIB
+/*
+    Permessage-deflate (RFC 7692) compression state
+ */
+typedef struct WebSockDeflate {
+    z_stream    tx;                 /* Outgoing message compressor */
+    z_stream    rx;                 /* Incoming message decompressor */
+    ssize       rxLength;           /* Decompressed length of the current incoming message */
+    int         txActive;           /* Compressor is initialized. Messages are sent uncompressed if not set */
+    int         rxActive;           /* Decompressor is initialized */
+    int         txMessage;          /* Current outgoing message is compressed */
+    int         rxMessage;          /* Current incoming message is compressed */
+    int         txNoContext;        /* Reset the compressor after each message */
+    int         rxNoContext;        /* Reset the decompressor after each message */
+} WebSockDeflate;
+
+/*
+    Messages smaller than this that are sent in a single frame are not worth compressing
+ */
+#define WS_DEFLATE_MIN          64
+
+/*
+    Empty stored block that terminates each compressed message. Removed by the sender and restored by the receiver.
+ */
+static cchar deflateTrailer[] = { 0x00, 0x00, (char) 0xff, (char) 0xff };
+#endif
+
 /*
     Copyright (c) 2008-2009 Bjoern Hoehrmann <bjoern@hoehrmann.de>
     See http://bjoern.hoehrmann.de/utf-8/decoder/dfa/ for details.
@@ -28405,6 +29254,11 @@ static char *codetxt[16] = {
 #define UTF8_ACCEPT 0
 #define UTF8_REJECT 1
 
+/*
+    High bit of every byte in a word. A word of ASCII characters has none set.
+ */
+#define UTF8_HIGH_BITS  0x8080808080808080ULL
+
 static const uchar utfTable[] = {
     0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, // 00..1f
     0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, // 20..3f
@@ -28426,6 +29280,7 @@ static const uchar utfTable[] = {
 
 static void closeWebSock(HttpQueue *q);
 static bool flushWsPipe(HttpQueue *q, int flags);
+static int applyMask(char *data, ssize len, cuchar *mask, int offset);
 static void incomingWebSockData(HttpQueue *q, HttpPacket *packet);
 static void manageWebSocket(HttpWebSocket *ws, int flags);
 static int matchWebSock(HttpStream *stream, HttpRoute *route, int dir);
@@ -28438,6 +29293,18 @@ static bool validateText(HttpStream *stream, HttpPacket *packet);
 static void webSockPing(HttpStream *stream);
 static void webSockTimeout(HttpStream *stream);
 
+#if ME_COM_ZLIB
+static void acceptDeflate(HttpStream *stream, cchar *offers);
+static WebSockDeflate *createDeflate(HttpStream *stream, int txBits, int rxBits, int txNoContext, int rxNoContext);
+static int deflatePacket(HttpStream *stream, HttpPacket *packet);
+static int inflateBlock(HttpStream *stream, MprBuf *buf, cchar *data, ssize len);
+static int inflatePacket(HttpStream *stream, HttpPacket *packet);
+static void manageDeflate(WebSockDeflate *dp, int flags);
+static bool parseDeflateParams(char *params, int *serverBits, int *clientBits, int *serverNoContext,
+    int *clientNoContext);
+static bool verifyDeflate(HttpStream *stream, cchar *extensions);
+#endif
+
 static void traceErrorProc(HttpStream *stream, cchar *fmt, ...);
 
 #define traceError(stream, ...) \
@@ -28560,6 +29427,11 @@ static int matchWebSock(HttpStream *stream, HttpRoute *route, int dir)
         if (ws->subProtocol && *ws->subProtocol) {
             httpSetHeaderString(stream, "Sec-WebSocket-Protocol", ws->subProtocol);
         }
+#if ME_COM_ZLIB
+        if (route->flags & HTTP_ROUTE_WEB_SOCKETS_DEFLATE) {
+            acceptDeflate(stream, httpGetHeader(stream, "sec-websocket-extensions"));
+        }
+#endif
 #if !ME_HTTP_WEB_SOCKETS_STEALTH
         httpSetHeader(stream, "X-Request-Timeout", "%lld", stream->limits->requestTimeout / TPS);
         httpSetHeader(stream, "X-Inactivity-Timeout", "%lld", stream->limits->inactivityTimeout / TPS);
@@ -28615,6 +29487,7 @@ static void manageWebSocket(HttpWebSocket *ws, int flags)
         mprMark(ws->errorMsg);
         mprMark(ws->closeReason);
         mprMark(ws->data);
+        mprMark(ws->deflate);
     }
 }
 
@@ -28652,9 +29525,9 @@ static void incomingWebSockData(HttpQueue *q, HttpPacket *packet)
     HttpPacket      *tail;
     HttpLimits      *limits;
     MprBuf          *content;
-    char            *fp, *cp;
+    char            *fp;
     ssize           len, currentFrameLen, offset, frameLen;
-    int             i, error, mask, lenBytes, opcode;
+    int             i, error, mask, lenBytes, opcode, rsv;
 
     assert(packet);
     stream = q->stream;
@@ -28705,13 +29578,23 @@ static void incomingWebSockData(HttpQueue *q, HttpPacket *packet)
                 return;
             }
             fp = content->start;
-            if (GET_RSV(*fp) != 0) {
+            rsv = GET_RSV(*fp);
+            opcode = GET_CODE(*fp);
+#if ME_COM_ZLIB
+            if (ws->deflate && (opcode == WS_MSG_TEXT || opcode == WS_MSG_BINARY)) {
+                /*
+                    RSV1 on the first frame of a message indicates a permessage-deflate compressed message
+                 */
+                ((WebSockDeflate*) ws->deflate)->rxMessage = (rsv & WS_RSV1) ? 1 : 0;
+                rsv &= ~WS_RSV1;
+            }
+#endif
+            if (rsv != 0) {
                 error = WS_STATUS_PROTOCOL_ERROR;
                 traceError(stream, "Protocol error, bad reserved field");
                 break;
             }
             packet->fin = GET_FIN(*fp);
-            opcode = GET_CODE(*fp);
             if (opcode == WS_MSG_CONT) {
                 if (!ws->currentMessageType) {
                     traceError(stream, "Protocol error, continuation frame but not prior message");
@@ -28804,9 +29687,7 @@ static void incomingWebSockData(HttpQueue *q, HttpPacket *packet)
                 break;
             }
             if (ws->maskOffset >= 0) {
-                for (cp = content->start; cp < content->end; cp++) {
-                    *cp = *cp ^ ws->dataMask[ws->maskOffset++ & 0x3];
-                }
+                ws->maskOffset = applyMask(content->start, mprGetBufLength(content), ws->dataMask, ws->maskOffset);
             }
             if (packet->type == WS_MSG_CONT && ws->currentFrame) {
                 httpJoinPacket(ws->currentFrame, packet);
@@ -28830,6 +29711,11 @@ static void incomingWebSockData(HttpQueue *q, HttpPacket *packet)
             frameLen = httpGetPacketLength(packet);
             assert(frameLen <= ws->frameLength);
             if (frameLen == ws->frameLength) {
+#if ME_COM_ZLIB
+                if (ws->deflate && packet->type < WS_MSG_CONTROL && (error = inflatePacket(stream, packet)) != 0) {
+                    break;
+                }
+#endif
                 if ((error = processWebSocketFrame(q, packet)) != 0) {
                     break;
                 }
@@ -29225,9 +30111,9 @@ static void outgoingWebSockService(HttpQueue *q)
     HttpStream      *stream;
     HttpPacket      *packet, *tail;
     HttpWebSocket   *ws;
-    char            *ep, *fp, *prefix, dataMask[4];
+    char            *prefix, dataMask[4];
     ssize           len;
-    int             i, mask;
+    int             i, mask, rsv;
 
     stream = q->stream;
     ws = stream->rx->webSocket;
@@ -29249,6 +30135,13 @@ static void outgoingWebSockService(HttpQueue *q)
                 httpError(stream, HTTP_CODE_INTERNAL_SERVER_ERROR, "Bad WebSocket packet type %d", packet->type);
                 break;
             }
+            rsv = 0;
+#if ME_COM_ZLIB
+            if (ws->deflate && packet->type < WS_MSG_CONTROL && (rsv = deflatePacket(stream, packet)) < 0) {
+                httpError(stream, HTTP_CODE_INTERNAL_SERVER_ERROR, "Cannot compress WebSocket message");
+                break;
+            }
+#endif
             len = httpGetPacketLength(packet);
             packet->prefix = mprCreateBuf(16, 16);
             prefix = packet->prefix->start;
@@ -29256,7 +30149,7 @@ static void outgoingWebSockService(HttpQueue *q)
                 Server-side does not mask outgoing data
              */
             mask = httpServerStream(stream) ? 0 : 1;
-            *prefix++ = SET_FIN(packet->fin) | SET_CODE(packet->type);
+            *prefix++ = SET_FIN(packet->fin) | SET_RSV1(rsv) | SET_CODE(packet->type);
             if (len <= WS_MAX_CONTROL) {
                 *prefix++ = SET_MASK(mask) | SET_LEN(len, 0);
             } else if (len <= 65535) {
@@ -29274,11 +30167,7 @@ static void outgoingWebSockService(HttpQueue *q)
                 for (i = 0; i < 4; i++) {
                     *prefix++ = dataMask[i];
                 }
-                fp = packet->content->start;
-                ep = packet->content->end;
-                for (i = 0; fp < ep; fp++) {
-                    *fp = *fp ^ dataMask[i++ & 0x3];
-                }
+                applyMask(packet->content->start, mprGetBufLength(packet->content), (cuchar*) dataMask, 0);
             }
             *prefix = '\0';
             mprAdjustBufEnd(packet->prefix, prefix - packet->prefix->start);
@@ -29406,11 +30295,22 @@ PUBLIC void httpSetWebSocketPreserveFrames(HttpStream *stream, bool on)
  */
 static int validUTF8(HttpStream *stream, cchar *str, ssize len)
 {
-    uchar   *cp, c;
+    uchar   *cp, *end, c;
+    uint64  *wp;
     uint    state, type;
 
     state = UTF8_ACCEPT;
-    for (cp = (uchar*) str; cp < (uchar*) &str[len]; cp++) {
+    end = (uchar*) &str[len];
+    for (cp = (uchar*) str; cp < end; cp++) {
+        if (state == UTF8_ACCEPT && ((size_t) cp & (sizeof(uint64) - 1)) == 0) {
+            /*
+                Between codepoints, skip aligned words of ASCII characters without running the state machine
+             */
+            for (wp = (uint64*) cp; (uchar*) &wp[1] <= end && !(*wp & UTF8_HIGH_BITS); wp++) ;
+            if ((cp = (uchar*) wp) >= end) {
+                break;
+            }
+        }
         c = *cp;
         type = utfTable[c];
         /*
@@ -29426,6 +30326,41 @@ static int validUTF8(HttpStream *stream, cchar *str, ssize len)
 }
 
 
+/*
+    Apply the WebSocket data mask starting at the given mask offset. Once the data is aligned, it is masked a word at a
+    time with the mask replicated across the word. Returns the updated mask offset.
+ */
+static int applyMask(char *data, ssize len, cuchar *mask, int offset)
+{
+    uchar   *cp, *end, bytes[sizeof(uint64)];
+    uint64  *wp, word;
+    int     i;
+
+    cp = (uchar*) data;
+    end = &cp[len];
+    for (; cp < end && ((size_t) cp & (sizeof(uint64) - 1)) != 0; cp++) {
+        *cp ^= mask[offset++ & 0x3];
+    }
+    if ((end - cp) >= (ssize) sizeof(uint64)) {
+        /*
+            The word size is a multiple of the mask size, so the mask offset is unchanged by whole words
+         */
+        for (i = 0; i < (int) sizeof(uint64); i++) {
+            bytes[i] = mask[(offset + i) & 0x3];
+        }
+        memcpy(&word, bytes, sizeof(word));
+        for (wp = (uint64*) cp; (uchar*) &wp[1] <= end; wp++) {
+            *wp ^= word;
+        }
+        cp = (uchar*) wp;
+    }
+    for (; cp < end; cp++) {
+        *cp ^= mask[offset++ & 0x3];
+    }
+    return offset & 0x3;
+}
+
+
 /*
     Validate the UTF8 in a packet. Return false if an invalid codepoint is found.
     If the packet is not the last packet, we alloc incomplete codepoints.
@@ -29501,6 +30436,19 @@ PUBLIC int httpUpgradeWebSocket(HttpStream *stream)
     httpSetHeaderString(stream, "Sec-WebSocket-Key", tx->webSockKey);
     httpSetHeaderString(stream, "Sec-WebSocket-Protocol", stream->protocols ? stream->protocols : "chat");
     httpSetHeaderString(stream, "Sec-WebSocket-Version", "13");
+#if ME_COM_ZLIB
+    if (HTTP->clientRoute && (HTTP->clientRoute->flags & HTTP_ROUTE_WEB_SOCKETS_DEFLATE)) {
+        /*
+            Offer permessage-deflate and bound the server window to limit decompression memory
+         */
+        if (stream->limits->webSocketsWindow < 15) {
+            httpSetHeader(stream, "Sec-WebSocket-Extensions",
+                "permessage-deflate; client_max_window_bits; server_max_window_bits=%d", stream->limits->webSocketsWindow);
+        } else {
+            httpSetHeaderString(stream, "Sec-WebSocket-Extensions", "permessage-deflate; client_max_window_bits");
+        }
+    }
+#endif
     httpSetHeader(stream, "X-Request-Timeout", "%lld", stream->limits->requestTimeout / TPS);
     httpSetHeader(stream, "X-Inactivity-Timeout", "%lld", stream->limits->inactivityTimeout / TPS);
 
@@ -29547,11 +30495,365 @@ PUBLIC bool httpVerifyWebSocketsHandshake(HttpStream *stream)
         httpError(stream, HTTP_CODE_BAD_HANDSHAKE, "Bad WebSocket handshake key\n%s\n%s", key, expected);
         return 0;
     }
+#if ME_COM_ZLIB
+    if (!verifyDeflate(stream, httpGetHeader(stream, "sec-websocket-extensions"))) {
+        return 0;
+    }
+#endif
     rx->webSocket->state = WS_STATE_OPEN;
     return 1;
 }
 
 
+#if ME_COM_ZLIB
+/*
+    Accept the first permessage-deflate offer in the Sec-WebSocket-Extensions header that can be supported.
+    The negotiated windows are bounded by the webSocketsWindow limit.
+ */
+static void acceptDeflate(HttpStream *stream, cchar *offers)
+{
+    HttpWebSocket   *ws;
+    MprBuf          *response;
+    char            *offer, *params, *tok;
+    int             clientBits, serverBits, clientNoContext, serverNoContext, limit, rxBits, txBits;
+
+    if (!offers) {
+        return;
+    }
+    ws = stream->rx->webSocket;
+    limit = stream->limits->webSocketsWindow;
+
+    for (offer = stok(sclone(offers), ",", &tok); offer; offer = stok(NULL, ",", &tok)) {
+        if ((params = schr(offer, ';')) != 0) {
+            *params++ = '\0';
+        }
+        if (!scaselessmatch(strim(offer, " \t", MPR_TRIM_BOTH), "permessage-deflate")) {
+            continue;
+        }
+        if (!parseDeflateParams(params, &serverBits, &clientBits, &serverNoContext, &clientNoContext)) {
+            continue;
+        }
+        /*
+            The client window can only be reduced if the client offers client_max_window_bits
+         */
+        if (clientBits < 0 && limit < 15) {
+            continue;
+        }
+        rxBits = (clientBits > 0) ? min(clientBits, limit) : limit;
+        txBits = (serverBits > 0) ? min(serverBits, limit) : limit;
+        if ((ws->deflate = createDeflate(stream, txBits, rxBits, serverNoContext, clientNoContext)) == 0) {
+            return;
+        }
+        response = mprCreateBuf(0, 0);
+        mprPutStringToBuf(response, "permessage-deflate");
+        if (serverNoContext) {
+            mprPutStringToBuf(response, "; server_no_context_takeover");
+        }
+        if (clientNoContext) {
+            mprPutStringToBuf(response, "; client_no_context_takeover");
+        }
+        if (txBits < 15) {
+            mprPutToBuf(response, "; server_max_window_bits=%d", txBits);
+        }
+        if (clientBits >= 0 && rxBits < 15) {
+            mprPutToBuf(response, "; client_max_window_bits=%d", rxBits);
+        }
+        mprAddNullToBuf(response);
+        httpSetHeaderString(stream, "Sec-WebSocket-Extensions", mprGetBufStart(response));
+        return;
+    }
+}
+
+
+/*
+    Client verification of the server permessage-deflate response
+ */
+static bool verifyDeflate(HttpStream *stream, cchar *extensions)
+{
+    HttpWebSocket   *ws;
+    char            *name, *params;
+    int             clientBits, serverBits, clientNoContext, serverNoContext, rxBits, txBits;
+
+    if (!extensions) {
+        return 1;
+    }
+    ws = stream->rx->webSocket;
+    name = sclone(extensions);
+    if ((params = schr(name, ';')) != 0) {
+        *params++ = '\0';
+    }
+    if (!HTTP->clientRoute || !(HTTP->clientRoute->flags & HTTP_ROUTE_WEB_SOCKETS_DEFLATE) ||
+            !scaselessmatch(strim(name, " \t", MPR_TRIM_BOTH), "permessage-deflate") ||
+            !parseDeflateParams(params, &serverBits, &clientBits, &serverNoContext, &clientNoContext)) {
+        httpError(stream, HTTP_CODE_BAD_HANDSHAKE, "Bad WebSocket extensions %s", extensions);
+        return 0;
+    }
+    rxBits = (serverBits > 0) ? serverBits : 15;
+    txBits = (clientBits > 0) ? clientBits : 15;
+    if (rxBits > stream->limits->webSocketsWindow) {
+        httpError(stream, HTTP_CODE_BAD_HANDSHAKE, "WebSocket deflate window %d exceeds the limit", rxBits);
+        return 0;
+    }
+    if ((ws->deflate = createDeflate(stream, txBits, rxBits, clientNoContext, serverNoContext)) == 0) {
+        httpError(stream, HTTP_CODE_BAD_HANDSHAKE, "Cannot initialize WebSocket compression");
+        return 0;
+    }
+    return 1;
+}
+
+
+/*
+    Parse permessage-deflate extension parameters. Window bits are set to -1 if absent and to zero if present without
+    a value. Returns false if a parameter is unknown, duplicated or has a bad value.
+ */
+static bool parseDeflateParams(char *params, int *serverBits, int *clientBits, int *serverNoContext,
+    int *clientNoContext)
+{
+    char    *key, *value, *tok;
+    int     *bits;
+
+    *serverBits = *clientBits = -1;
+    *serverNoContext = *clientNoContext = 0;
+    if (!params) {
+        return 1;
+    }
+    for (key = stok(params, ";", &tok); key; key = stok(NULL, ";", &tok)) {
+        if ((value = schr(key, '=')) != 0) {
+            *value++ = '\0';
+            value = strim(value, " \t\"", MPR_TRIM_BOTH);
+        }
+        key = strim(key, " \t", MPR_TRIM_BOTH);
+        if (*key == '\0') {
+            continue;
+        }
+        if (scaselessmatch(key, "server_no_context_takeover")) {
+            if (value || *serverNoContext) {
+                return 0;
+            }
+            *serverNoContext = 1;
+
+        } else if (scaselessmatch(key, "client_no_context_takeover")) {
+            if (value || *clientNoContext) {
+                return 0;
+            }
+            *clientNoContext = 1;
+
+        } else if (scaselessmatch(key, "server_max_window_bits") || scaselessmatch(key, "client_max_window_bits")) {
+            bits = scaselessmatch(key, "server_max_window_bits") ? serverBits : clientBits;
+            if (*bits >= 0) {
+                return 0;
+            }
+            if (value) {
+                if (!snumber(value) || stoi(value) < 8 || stoi(value) > 15) {
+                    return 0;
+                }
+                *bits = (int) stoi(value);
+            } else if (bits == serverBits) {
+                return 0;
+            } else {
+                *bits = 0;
+            }
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*
+    Create the compression state. Zlib cannot compress raw deflate data with an 8 bit window, so if the peer requires
+    that, messages are sent uncompressed which the extension permits. The zlib memory level scales with the window
+    so the webSocketsWindow limit bounds the total memory used.
+ */
+static WebSockDeflate *createDeflate(HttpStream *stream, int txBits, int rxBits, int txNoContext, int rxNoContext)
+{
+    WebSockDeflate  *dp;
+
+    if ((dp = mprAllocObj(WebSockDeflate, manageDeflate)) == 0) {
+        return 0;
+    }
+    if (txBits >= 9) {
+        if (deflateInit2(&dp->tx, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -txBits, txBits - 7, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return 0;
+        }
+        dp->txActive = 1;
+    }
+    if (inflateInit2(&dp->rx, -rxBits) != Z_OK) {
+        return 0;
+    }
+    dp->rxActive = 1;
+    dp->txNoContext = txNoContext;
+    dp->rxNoContext = rxNoContext;
+    if (httpShouldTrace(stream->trace, "context")) {
+        httpLogProc(stream->trace, "websockets.deflate", "context", 0,
+            "txWindow:%d, rxWindow:%d, txNoContext:%d, rxNoContext:%d",
+            dp->txActive ? txBits : 0, rxBits, txNoContext, rxNoContext);
+    }
+    return dp;
+}
+
+
+static void manageDeflate(WebSockDeflate *dp, int flags)
+{
+    if (flags & MPR_MANAGE_FREE) {
+        if (dp->txActive) {
+            deflateEnd(&dp->tx);
+        }
+        if (dp->rxActive) {
+            inflateEnd(&dp->rx);
+        }
+    }
+}
+
+
+/*
+    Compress an outgoing data frame. The compressed frame replaces the packet content.
+    Returns 1 if the frame starts a compressed message and must set RSV1, zero if not and a negative error code.
+ */
+static int deflatePacket(HttpStream *stream, HttpPacket *packet)
+{
+    WebSockDeflate  *dp;
+    MprBuf          *buf;
+    ssize           len, space;
+    int             flush;
+
+    dp = stream->rx->webSocket->deflate;
+    len = httpGetPacketLength(packet);
+    if (packet->type != WS_MSG_CONT) {
+        dp->txMessage = dp->txActive && !(packet->fin && len < WS_DEFLATE_MIN);
+    }
+    if (!dp->txMessage) {
+        return 0;
+    }
+    if ((buf = mprCreateBuf(len + 64, 0)) == 0) {
+        return MPR_ERR_MEMORY;
+    }
+    /*
+        Only flush at the end of a message so the message frames form one deflate stream
+     */
+    flush = packet->fin ? Z_SYNC_FLUSH : Z_NO_FLUSH;
+    dp->tx.next_in = (Bytef*) (packet->content ? mprGetBufStart(packet->content) : 0);
+    dp->tx.avail_in = (uInt) len;
+    do {
+        if (mprGetBufSpace(buf) == 0 && mprGrowBuf(buf, mprGetBufSize(buf)) < 0) {
+            return MPR_ERR_MEMORY;
+        }
+        space = mprGetBufSpace(buf);
+        dp->tx.next_out = (Bytef*) mprGetBufEnd(buf);
+        dp->tx.avail_out = (uInt) space;
+        if (deflate(&dp->tx, flush) == Z_STREAM_ERROR) {
+            return MPR_ERR_BAD_STATE;
+        }
+        mprAdjustBufEnd(buf, space - (ssize) dp->tx.avail_out);
+    } while (dp->tx.avail_out == 0);
+
+    if (packet->fin) {
+        if (mprGetBufLength(buf) >= 4 && memcmp(mprGetBufEnd(buf) - 4, deflateTrailer, 4) == 0) {
+            mprAdjustBufEnd(buf, -4);
+        }
+        if (dp->txNoContext) {
+            deflateReset(&dp->tx);
+        }
+    }
+    packet->content = buf;
+    return packet->type != WS_MSG_CONT;
+}
+
+
+/*
+    Decompress a complete incoming data frame. The final frame of a message has the deflate trailer restored.
+    Returns zero or a WebSocket close status.
+ */
+static int inflatePacket(HttpStream *stream, HttpPacket *packet)
+{
+    WebSockDeflate  *dp;
+    MprBuf          *buf, *content;
+    ssize           len, size;
+    int             status;
+
+    dp = stream->rx->webSocket->deflate;
+    if (!dp->rxMessage) {
+        return 0;
+    }
+    content = packet->content;
+    len = mprGetBufLength(content);
+
+    /*
+        Start with a frame sized buffer, but never more than the remaining message allowance (plus one byte to detect overflow)
+     */
+    size = min(stream->limits->webSocketsMessageSize - dp->rxLength + 1, stream->limits->webSocketsFrameSize);
+    if ((buf = mprCreateBuf(max(size, 1), 0)) == 0) {
+        return WS_STATUS_MESSAGE_TOO_LARGE;
+    }
+    if ((status = inflateBlock(stream, buf, mprGetBufStart(content), len)) != 0) {
+        return status;
+    }
+    if (packet->fin) {
+        if ((status = inflateBlock(stream, buf, deflateTrailer, sizeof(deflateTrailer))) != 0) {
+            return status;
+        }
+        dp->rxMessage = 0;
+        dp->rxLength = 0;
+        if (dp->rxNoContext) {
+            inflateReset(&dp->rx);
+        }
+    } else {
+        dp->rxLength += mprGetBufLength(buf);
+    }
+    packet->content = buf;
+    return 0;
+}
+
+
+/*
+    Decompress a block of data into the buffer. The decompressed message size is bounded by webSocketsMessageSize.
+    Each inflate call is limited to the remaining allowance plus one byte, so an oversized message is detected
+    without inflating more than the limit.
+ */
+static int inflateBlock(HttpStream *stream, MprBuf *buf, cchar *data, ssize len)
+{
+    WebSockDeflate  *dp;
+    ssize           allowance, space;
+    int             rc;
+
+    dp = stream->rx->webSocket->deflate;
+    dp->rx.next_in = (Bytef*) data;
+    dp->rx.avail_in = (uInt) len;
+    do {
+        allowance = stream->limits->webSocketsMessageSize - dp->rxLength - mprGetBufLength(buf);
+        if (allowance < 0) {
+            if (httpServerStream(stream)) {
+                httpMonitorEvent(stream, HTTP_COUNTER_LIMIT_ERRORS, 1);
+            }
+            traceErrorProc(stream, "Incoming message is too large when decompressed, max %d",
+                stream->limits->webSocketsMessageSize);
+            return WS_STATUS_MESSAGE_TOO_LARGE;
+        }
+        if (mprGetBufSpace(buf) == 0 && mprGrowBuf(buf, min(mprGetBufSize(buf), allowance + 1)) < 0) {
+            return WS_STATUS_MESSAGE_TOO_LARGE;
+        }
+        space = min(mprGetBufSpace(buf), allowance + 1);
+        dp->rx.next_out = (Bytef*) mprGetBufEnd(buf);
+        dp->rx.avail_out = (uInt) space;
+        rc = inflate(&dp->rx, Z_SYNC_FLUSH);
+        mprAdjustBufEnd(buf, space - (ssize) dp->rx.avail_out);
+        if (rc == Z_STREAM_END) {
+            /*
+                The peer ended the deflate stream with a final block. Start a new stream for the next message.
+             */
+            inflateReset(&dp->rx);
+            break;
+        } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            traceErrorProc(stream, "Cannot decompress message");
+            return WS_STATUS_PROTOCOL_ERROR;
+        }
+    } while (dp->rx.avail_out == 0);
+    return 0;
+}
+#endif /* ME_COM_ZLIB */
+
+
 static void traceErrorProc(HttpStream *stream, cchar *fmt, ...)
 {
     HttpWebSocket   *ws;
@@ -36,29 +36,71 @@
 #define OP_GTE      0x20        /* "<=" Greater than or equal operation */
 #define OP_IN       0x40        /* Contains */
 
+/*
+    Cell value types
+ */
+#define MDB_NUM_BUF 32          /* Buffer size to format numeric cell values */
+
+/*
+    Binary snapshot format
+ */
+#define MDB_MAGIC           "\x89MDB"
+#define MDB_MAGIC_LEN       4
+#define MDB_VERSION         1
+#define MDB_TABLE_COLUMNAR  0x1
+
+typedef struct MdbReader {
+    cuchar          *pos;               /* Current read position */
+    cuchar          *end;               /* End of data */
+    bool            error;              /* Read past the end of data */
+} MdbReader;
+#define IS_NUMERIC_TYPE(type) ((type) == EDI_TYPE_BOOL || (type) == EDI_TYPE_DATE || \
+                               (type) == EDI_TYPE_FLOAT || (type) == EDI_TYPE_INT)
+#define IS_STRING_TYPE(type)  ((type) == EDI_TYPE_BINARY || (type) == EDI_TYPE_STRING || (type) == EDI_TYPE_TEXT)
+
 /************************************ Forwards ********************************/
 
+static int aggregateCell(MdbCell *cell, int op, int count, double *total);
 static void autoSave(Mdb *mdb, MdbTable *table);
+static void autoSaveRow(Mdb *mdb, MdbTable *table, cchar *op, cchar *key, MdbRow *row);
+static int compareCells(MdbCell *c1, MdbCell *c2);
 static MdbCol *createCol(MdbTable *table, cchar *columnName);
+static MprHash *createIndex(MdbTable *table, MdbCol *col, cchar *indexName);
+static MdbQuery *compileQuery(MdbTable *table, cchar *query);
 static EdiRec *createRecFromRow(Edi *edi, MdbRow *row);
 static MdbRow *createRow(Mdb *mdb, MdbTable *table);
+static cchar *formatCell(MdbCell *cell, char *buf, ssize bufsize);
+static cchar *getCellString(MdbCell *cell);
+static MdbCell *getCell(MdbRow *row, int cid);
 static MdbCol *getCol(MdbTable *table, int col);
 static MdbRow *getRow(MdbTable *table, int rid);
 static MdbTable *getTable(Mdb *mdb, int tid);
+static MdbQuery *getQuery(Mdb *mdb, MdbTable *table, cchar *query);
+static int growCells(MdbCol *col, int ncells);
 static MdbSchema *growSchema(MdbTable *table);
+static void indexRow(MdbCol *col, MdbRow *row);
+static MprList *lookupIndex(MdbCol *col, cchar *value);
 static MdbCol *lookupField(MdbTable *table, cchar *columnName);
 static int lookupRow(MdbTable *table, cchar *key);
 static MdbTable *lookupTable(Mdb *mdb, cchar *tableName);
 static void manageCol(MdbCol *col, int flags);
+static void manageCursor(MdbCursor *cp, int flags);
 static void manageMdb(Mdb *mdb, int flags);
+static void manageQuery(MdbQuery *query, int flags);
 static void manageRow(MdbRow *row, int flags);
 static void manageSchema(MdbSchema *schema, int flags);
 static void manageTable(MdbTable *table, int flags);
+static void parseCell(MdbCell *cell, int type, cchar *value);
 static int parseOperation(cchar *operation);
+static void removeRow(MdbTable *table, int r);
+static int replayJournal(Mdb *mdb, cchar *path);
+static void resetJournal(Mdb *mdb);
+static void unindexRow(MdbCol *col, MdbRow *row);
 static int updateFieldValue(MdbRow *row, MdbCol *col, cchar *value);
 static int mdbAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type, int flags);
 static int mdbAddIndex(Edi *edi, cchar *tableName, cchar *columnName, cchar *indexName);
 static int mdbAddTable(Edi *edi, cchar *tableName);
+static int mdbAggregate(Edi *edi, cchar *tableName, cchar *columnName, cchar *query, int op, double *result);
 static int mdbChangeColumn(Edi *edi, cchar *tableName, cchar *columnName, int type, int flags);
 static void mdbClose(Edi *edi);
 static EdiRec *mdbCreateRec(Edi *edi, cchar *tableName);
@@ -70,8 +112,12 @@ static MprList *mdbGetTables(Edi *edi);
 static int mdbGetTableDimensions(Edi *edi, cchar *tableName, int *numRows, int *numCols);
 static int mdbLoad(Edi *edi, cchar *path);
 static int mdbLoadFromString(Edi *edi, cchar *string);
+static int mdbLoadBinary(Mdb *mdb, cchar *data, ssize len);
+static int mapBinary(Mdb *mdb, cchar *path);
 static int mdbLookupField(Edi *edi, cchar *tableName, cchar *fieldName);
+static EdiRec *mdbNextRec(EdiCursor *cursor);
 static Edi *mdbOpen(cchar *path, int flags);
+static int mdbOpenCursor(EdiCursor *cursor, cchar *query);
 static EdiGrid *mdbQuery(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list vargs);
 static EdiField mdbReadField(Edi *edi, cchar *tableName, cchar *key, cchar *fieldName);
 static EdiRec *mdbReadRecByKey(Edi *edi, cchar *tableName, cchar *key);
@@ -90,7 +136,8 @@ static EdiProvider MdbProvider = {
     mdbAddColumn, mdbAddIndex, mdbAddTable, mdbChangeColumn, mdbClose, mdbCreateRec, mdbDelete,
     mdbGetColumns, mdbGetColumnSchema, mdbGetTables, mdbGetTableDimensions, mdbLoad, mdbLookupField, mdbOpen, mdbQuery,
     mdbReadField, mdbFindGrid, mdbReadRecByKey, mdbRemoveColumn, mdbRemoveIndex, mdbRemoveRec, mdbRemoveTable,
-    mdbRenameTable, mdbRenameColumn, mdbSave, mdbUpdateField, mdbUpdateRec,
+    mdbRenameTable, mdbRenameColumn, mdbSave, mdbUpdateField, mdbUpdateRec, NULL, mdbOpenCursor, mdbNextRec, NULL,
+    NULL, mdbAggregate,
 };
 
 /************************************* Code ***********************************/
@@ -127,6 +174,7 @@ static void manageMdb(Mdb *mdb, int flags)
         mprMark(mdb->edi.validations);
         mprMark(mdb->edi.mutex);
         mprMark(mdb->tables);
+        mprMark(mdb->journal);
         /* Don't mark load fields */
     } else {
         mdbClose((Edi*) mdb);
@@ -248,12 +296,11 @@ static int mdbAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type,
     }
     col->type = type;
     col->flags = flags;
+    table->queries = 0;
     if (flags & EDI_INDEX) {
-        if (table->index) {
-            mprLog("warn esp mdb", 0, "Index already specified in table %s, replacing.", tableName);
-        }
-        if ((table->index = mprCreateHash(0, MPR_HASH_STATIC_VALUES | MPR_HASH_STABLE)) != 0) {
-            table->indexCol = col;
+        if (createIndex(table, col, NULL) == 0) {
+            unlock(edi);
+            return MPR_ERR_MEMORY;
         }
     }
     autoSave(mdb, table);
@@ -264,7 +311,7 @@ static int mdbAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type,
 
 
 /*
-    IndexName is not implemented yet
+    Create a value index on any column. The indexName defaults to the column name.
  */
 static int mdbAddIndex(Edi *edi, cchar *tableName, cchar *columnName, cchar *indexName)
 {
@@ -286,12 +333,10 @@ static int mdbAddIndex(Edi *edi, cchar *tableName, cchar *columnName, cchar *ind
         unlock(edi);
         return MPR_ERR_CANT_FIND;
     }
-    if ((table->index = mprCreateHash(0, MPR_HASH_STATIC_VALUES | MPR_HASH_STABLE)) == 0) {
+    if (createIndex(table, col, indexName) == 0) {
         unlock(edi);
         return MPR_ERR_MEMORY;
     }
-    table->indexCol = col;
-    col->flags |= EDI_INDEX;
     autoSave(mdb, table);
     unlock(edi);
     return 0;
@@ -321,6 +366,7 @@ static int mdbAddTable(Edi *edi, cchar *tableName)
         return MPR_ERR_MEMORY;
     }
     table->name = sclone(tableName);
+    table->columnar = (mdb->edi.flags & EDI_COLUMNAR) ? 1 : 0;
     if (mdb->tables == 0) {
         mdb->tables = mprCreateList(0, MPR_LIST_STABLE);
     }
@@ -340,6 +386,9 @@ static int mdbChangeColumn(Edi *edi, cchar *tableName, cchar *columnName, int ty
     Mdb         *mdb;
     MdbTable    *table;
     MdbCol      *col;
+    MdbRow      *row;
+    MdbCell     *cell;
+    int         next;
 
     assert(edi);
     assert(tableName && *tableName);
@@ -357,7 +406,18 @@ static int mdbChangeColumn(Edi *edi, cchar *tableName, cchar *columnName, int ty
         return MPR_ERR_CANT_FIND;
     }
     col->name = sclone(columnName);
-    col->type = type;
+    if (type != col->type) {
+        /*
+            Convert existing values to the new type. Values that cannot be converted are kept as strings.
+         */
+        col->type = type;
+        for (ITERATE_ITEMS(table->rows, row, next)) {
+            if ((cell = getCell(row, col->cid)) != 0 && cell->type) {
+                updateFieldValue(row, col, getCellString(cell));
+            }
+        }
+    }
+    table->queries = 0;
     autoSave(mdb, table);
     unlock(edi);
     return 0;
@@ -397,14 +457,15 @@ static MprList *mdbGetColumns(Edi *edi, cchar *tableName)
 
 
 /*
-    Make a field. WARNING: the value is not cloned
+    Make a field. WARNING: string values are not cloned
  */
 static EdiField makeFieldFromRow(MdbRow *row, MdbCol *col)
 {
     EdiField    f;
+    MdbCell     *cell;
 
-    /* Note: the value is not cloned */
-    f.value = row->fields[col->cid];
+    /* Note: string values are not cloned */
+    f.value = (cell = getCell(row, col->cid)) != 0 ? getCellString(cell) : 0;
     f.type = col->type;
     f.name = col->name;
     f.flags = col->flags;
@@ -501,11 +562,28 @@ static int mdbLoad(Edi *edi, cchar *path)
 {
     cchar       *data;
     ssize       len;
+    int         rc;
 
+    if ((rc = mapBinary((Mdb*) edi, path)) != MPR_ERR_CANT_FIND) {
+        if (rc < 0) {
+            return MPR_ERR_CANT_LOAD;
+        }
+        edi->flags |= EDI_BINARY;
+        return replayJournal((Mdb*) edi, mprReplacePathExt(path, "jnl"));
+    }
     if ((data = mprReadPathContents(path, &len)) == 0) {
         return MPR_ERR_CANT_READ;
     }
-    return mdbLoadFromString(edi, data);
+    if (len >= MDB_MAGIC_LEN && memcmp(data, MDB_MAGIC, MDB_MAGIC_LEN) == 0) {
+        if (mdbLoadBinary((Mdb*) edi, data, len) < 0) {
+            return MPR_ERR_CANT_LOAD;
+        }
+        /* Continue to save in the format that was loaded */
+        edi->flags |= EDI_BINARY;
+    } else if (mdbLoadFromString(edi, data) < 0) {
+        return MPR_ERR_CANT_LOAD;
+    }
+    return replayJournal((Mdb*) edi, mprReplacePathExt(path, "jnl"));
 }
 
 
@@ -596,44 +674,49 @@ static EdiRec *mdbReadRecByKey(Edi *edi, cchar *tableName, cchar *key)
 }
 
 
-static bool matchCell(MdbCol *col, cchar *existing, int op, cchar *value)
+/*
+    Match a cell against a query term. Numeric cells are compared numerically, others as strings.
+ */
+static bool matchCell(MdbCell *cell, MdbTerm *term)
 {
-    if (value == 0 || *value == '\0') {
+    char    buf[MDB_NUM_BUF];
+
+    if (term->value == 0 || *term->value == '\0') {
         return 0;
     }
-    switch (op) {
+    switch (term->op) {
     case OP_IN:
-        if (scontains(slower(existing), slower(value))) {
+        if (scaselesscontains(formatCell(cell, buf, sizeof(buf)), term->value)) {
             return 1;
         }
         break;
     case OP_EQ:
-        if (smatch(existing, value)) {
+        if (compareCells(cell, &term->cell) == 0) {
             return 1;
         }
         break;
     case OP_NEQ:
-        if (!smatch(existing, value)) {
+        if (compareCells(cell, &term->cell) != 0) {
             return 1;
         }
         break;
     case OP_LT:
-        if (scmp(existing, value) < 0) {
+        if (compareCells(cell, &term->cell) < 0) {
             return 1;
         }
         break;
     case OP_GT:
-        if (scmp(existing, value) > 0) {
+        if (compareCells(cell, &term->cell) > 0) {
             return 1;
         }
         break;
     case OP_LTE:
-        if (scmp(existing, value) <= 0) {
+        if (compareCells(cell, &term->cell) <= 0) {
             return 1;
         }
         break;
     case OP_GTE:
-        if (scmp(existing, value) >= 0) {
+        if (compareCells(cell, &term->cell) >= 0) {
             return 1;
         }
         break;
@@ -644,14 +727,15 @@ static bool matchCell(MdbCol *col, cchar *existing, int op, cchar *value)
 }
 
 
-static bool matchRow(MdbTable *table, MdbRow *row, int op, cchar *value)
+static bool matchRow(MdbTable *table, MdbRow *row, MdbTerm *term)
 {
     MdbCol      *col;
+    MdbCell     *cell;
     MdbSchema   *schema;
 
     schema = table->schema;
     for (col = schema->cols; col < &schema->cols[schema->ncols]; col++) {
-        if (matchCell(col, row->fields[col->cid], op, value)) {
+        if ((cell = getCell(row, col->cid)) != 0 && matchCell(cell, term)) {
             return 1;
         }
     }
@@ -660,28 +744,81 @@ static bool matchRow(MdbTable *table, MdbRow *row, int op, cchar *value)
 
 
 /*
-    parse a SQL like query expression.
+    Evaluate a compiled query against a row
+ */
+static bool matchQuery(MdbTable *table, MdbQuery *qp, MdbRow *row)
+{
+    MdbTerm     *term;
+    MdbCell     *cell;
+
+    for (term = qp->terms; term < &qp->terms[qp->nterms]; term++) {
+        if (term->cid < 0) {
+            if (!matchRow(table, row, term)) {
+                return 0;
+            }
+        } else if ((cell = getCell(row, term->cid)) == 0 || !matchCell(cell, term)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*
+    Evaluate a compiled query against a row of a columnar table. This reads only the column cell arrays.
+ */
+static bool matchColumns(MdbTable *table, MdbQuery *qp, int rid)
+{
+    MdbSchema   *schema;
+    MdbTerm     *term;
+    MdbCol      *col;
+
+    schema = table->schema;
+    for (term = qp->terms; term < &qp->terms[qp->nterms]; term++) {
+        if (term->cid < 0) {
+            for (col = schema->cols; col < &schema->cols[schema->ncols]; col++) {
+                if (matchCell(&col->cells[rid], term)) {
+                    break;
+                }
+            }
+            if (col >= &schema->cols[schema->ncols]) {
+                return 0;
+            }
+        } else if (!matchCell(&schema->cols[term->cid].cells[rid], term)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*
+    Compile a SQL like query expression of the form: "column op value [AND ...] [LIMIT offset, count]".
+    The column may be "*" to match any column.
  */
-static MprList *parseMdbQuery(cchar *query, int *offsetp, int *limitp)
+static MdbQuery *compileQuery(MdbTable *table, cchar *query)
 {
+    MdbQuery    *qp;
+    MdbTerm     *term;
+    MdbCol      *col;
     MprList     *expressions;
-    char        *cp, *limit, *offset, *tok;
+    cchar       *columnName, *operation;
+    char        *buf, *cp, *expression, *limit, *offset, *tok, *value;
+    int         next;
 
-    *offsetp = *limitp = 0;
-    expressions = mprCreateList(0, 0);
-    query = sclone(query);
-    if ((cp = scaselesscontains(query, "LIMIT ")) != 0) {
+    expressions = mprCreateList(0, MPR_LIST_STABLE);
+    buf = sclone(query);
+    offset = limit = 0;
+    if ((cp = scaselesscontains(buf, "LIMIT ")) != 0) {
         *cp = '\0';
         cp += 6;
         offset = stok(cp, ", ", &limit);
         if (!offset || !limit) {
             return 0;
         }
-        *offsetp = (int) stoi(offset);
-        *limitp = (int) stoi(limit);
     }
-    query = strim(query, " ", 0);
-    for (tok = sclone(query); *tok && (cp = scontains(tok, " AND ")) != 0; ) {
+    buf = strim(buf, " ", 0);
+    for (tok = buf; *tok && (cp = scontains(tok, " AND ")) != 0; ) {
         *cp = '\0';
         cp += 5;
         mprAddItem(expressions, tok);
@@ -690,7 +827,112 @@ static MprList *parseMdbQuery(cchar *query, int *offsetp, int *limitp)
     if (tok && *tok) {
         mprAddItem(expressions, tok);
     }
-    return expressions;
+    if ((qp = mprAllocBlock(sizeof(MdbQuery) + sizeof(MdbTerm) * mprGetListLength(expressions),
+            MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO)) == 0) {
+        return 0;
+    }
+    mprSetManager(qp, (MprManager) manageQuery);
+    qp->source = buf;
+    if (offset) {
+        qp->offset = max((int) stoi(offset), 0);
+        qp->limit = (int) stoi(limit);
+    }
+    if (qp->limit <= 0) {
+        qp->limit = MAXINT;
+    }
+    for (ITERATE_ITEMS(expressions, expression, next)) {
+        term = &qp->terms[qp->nterms++];
+        columnName = stok(expression, " ", &tok);
+        operation = stok(tok, " ", &value);
+        if ((term->op = parseOperation(operation)) < 0) {
+            return 0;
+        }
+        term->value = value;
+        if (smatch(columnName, "*")) {
+            /* Match any column compares as strings */
+            term->cid = -1;
+            parseCell(&term->cell, EDI_TYPE_STRING, value);
+        } else if ((col = lookupField(table, columnName)) != 0) {
+            /* Convert the comparison value once to the column type */
+            term->cid = col->cid;
+            parseCell(&term->cell, col->type, value);
+        } else {
+            mprLog("error esp mdb", 0, "Cannot find column %s in table %s", columnName, table->name);
+            return 0;
+        }
+    }
+    return qp;
+}
+
+
+static void manageQuery(MdbQuery *qp, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(qp->source);
+    }
+}
+
+
+/*
+    Get a compiled query from the table query cache. Compile and cache if required, evicting the least recently used.
+ */
+static MdbQuery *getQuery(Mdb *mdb, MdbTable *table, cchar *query)
+{
+    MdbQuery    *qp;
+    MprKey      *kp, *oldest;
+
+    query = query ? query : "";
+    if (table->queries && (qp = mprLookupKey(table->queries, query)) != 0) {
+        qp->used = ++mdb->querySeq;
+        return qp;
+    }
+    if ((qp = compileQuery(table, query)) == 0) {
+        return 0;
+    }
+    qp->used = ++mdb->querySeq;
+    if (MDB_QUERY_CACHE <= 0) {
+        return qp;
+    }
+    if (table->queries == 0) {
+        table->queries = mprCreateHash(MDB_QUERY_CACHE, MPR_HASH_STABLE);
+    } else if (mprGetHashLength(table->queries) >= MDB_QUERY_CACHE) {
+        oldest = 0;
+        for (ITERATE_KEYS(table->queries, kp)) {
+            if (oldest == 0 || ((MdbQuery*) kp->data)->used < ((MdbQuery*) oldest->data)->used) {
+                oldest = kp;
+            }
+        }
+        mprRemoveKey(table->queries, oldest->key);
+    }
+    mprAddKey(table->queries, query, qp);
+    return qp;
+}
+
+
+/*
+    Select the candidate rows for a query. Use the most selective indexed equality term to narrow the candidate rows.
+    Index row lists are ordered by rid so the results are in table order. Returns null if no row can match.
+ */
+static MprList *selectRows(MdbTable *table, MdbQuery *qp)
+{
+    MdbTerm     *term;
+    MdbCol      *col;
+    MprList     *candidates, *rows;
+    char        buf[MDB_NUM_BUF];
+
+    rows = table->rows;
+    for (term = qp->terms; term < &qp->terms[qp->nterms]; term++) {
+        if (term->op == OP_EQ && term->cid >= 0 && (col = getCol(table, term->cid)) != 0 && col->index) {
+            if ((candidates = lookupIndex(col, formatCell(&term->cell, buf, sizeof(buf)))) == 0) {
+                /* No row has this value */
+                return 0;
+            }
+            if (candidates->length < rows->length) {
+                rows = candidates;
+            }
+        }
+    }
+    return rows;
 }
 
 
@@ -699,24 +941,24 @@ static EdiGrid *mdbFindGrid(Edi *edi, cchar *tableName, cchar *query)
     Mdb         *mdb;
     EdiGrid     *grid;
     MdbTable    *table;
-    MdbCol      *col;
+    MdbQuery    *qp;
     MdbRow      *row;
-    MprList     *expressions;
-    cchar       *columnName, *expression, *operation;
-    char        *tok, *value;
-    int         limit, matched, nrows, next, offset, op, r, index, count, nextExpression;
+    MprList     *rows;
+    int         limit, next, index, count, nrows, rid;
 
     assert(edi);
     assert(tableName && *tableName);
-    columnName = operation = value = 0;
     mdb = (Mdb*) edi;
     lock(edi);
     if ((table = lookupTable(mdb, tableName)) == 0) {
         unlock(edi);
         return 0;
     }
-    nrows = mprGetListLength(table->rows);
-    if ((grid = ediCreateBareGrid(edi, tableName, nrows)) == 0) {
+    if ((qp = getQuery(mdb, table, query)) == 0) {
+        unlock(edi);
+        return 0;
+    }
+    if ((grid = ediCreateBareGrid(edi, tableName, mprGetListLength(table->rows))) == 0) {
         unlock(edi);
         return 0;
     }
@@ -724,80 +966,192 @@ static EdiGrid *mdbFindGrid(Edi *edi, cchar *tableName, cchar *query)
     grid->nrecords = 0;
     grid->count = table->rows->length;
 
-    if ((expressions = parseMdbQuery(query, &offset, &limit)) == 0) {
+    if ((rows = selectRows(table, qp)) == 0) {
         unlock(edi);
-        return 0;
-    }
-    if (limit <= 0) {
-        limit = MAXINT;
-    }
-    if (offset < 0) {
-        offset = 0;
+        return grid;
     }
+    limit = qp->limit;
     count = index = 0;
-
-    /*
-        Optimized path for solo indexed lookup on "id"
-     */
-    if (mprGetListLength(expressions) == 1) {
-        expression = mprGetItem(expressions, 0);
-        columnName = stok(sclone(expression), " ", &tok);
-        operation = stok(tok, " ", &value);
-        if (smatch(columnName, "id") && smatch(operation, "==")) {
-            if ((col = lookupField(table, columnName)) == 0) {
-                unlock(edi);
-                return 0;
+    if (table->columnar && rows == table->rows) {
+        /*
+            Columnar scan. Stream through the column cell arrays and only touch matching rows.
+         */
+        nrows = mprGetListLength(table->rows);
+        for (rid = 0; rid < nrows; rid++) {
+            if (matchColumns(table, qp, rid) && count++ >= qp->offset) {
+                grid->records[index++] = createRecFromRow(edi, getRow(table, rid));
+                grid->nrecords = index;
+                if (--limit <= 0) {
+                    break;
+                }
             }
-            if (col->flags & EDI_INDEX) {
-                if ((r = lookupRow(table, value)) >= 0) {
-                    row = getRow(table, r);
-                    grid->records[0] = createRecFromRow(edi, row);
-                    grid->nrecords = 1;
+        }
+    } else {
+        for (ITERATE_ITEMS(rows, row, next)) {
+            if (matchQuery(table, qp, row) && count++ >= qp->offset) {
+                grid->records[index++] = createRecFromRow(edi, row);
+                grid->nrecords = index;
+                if (--limit <= 0) {
+                    break;
                 }
-                unlock(edi);
-                return grid;
             }
         }
     }
+    unlock(edi);
+    return grid;
+}
 
-    /*
-        Linear search
-     */
-    for (ITERATE_ITEMS(table->rows, row, next)) {
-        matched = 1;
-        for (ITERATE_ITEMS(expressions, expression, nextExpression)) {
-            columnName = stok(sclone(expression), " ", &tok);
-            operation = stok(tok, " ", &value);
-            if ((op = parseOperation(operation)) < 0) {
-                unlock(edi);
-                return 0;
+
+/*
+    Aggregate the numeric values of a column for the rows matching a query
+ */
+static int mdbAggregate(Edi *edi, cchar *tableName, cchar *columnName, cchar *query, int op, double *result)
+{
+    Mdb         *mdb;
+    MdbTable    *table;
+    MdbQuery    *qp;
+    MdbCol      *col;
+    MdbRow      *row;
+    MprList     *rows;
+    double      total;
+    int         count, limit, matched, next, nrows, rid;
+
+    assert(edi);
+    assert(tableName && *tableName);
+    mdb = (Mdb*) edi;
+    lock(edi);
+    if ((table = lookupTable(mdb, tableName)) == 0 || (col = lookupField(table, columnName)) == 0) {
+        unlock(edi);
+        return MPR_ERR_CANT_FIND;
+    }
+    if ((qp = getQuery(mdb, table, query)) == 0) {
+        unlock(edi);
+        return MPR_ERR_BAD_ARGS;
+    }
+    total = 0;
+    count = matched = 0;
+    limit = qp->limit;
+    rows = selectRows(table, qp);
+    if (table->columnar && rows == table->rows) {
+        /*
+            Columnar scan. Stream through the column cell arrays without touching the rows.
+         */
+        nrows = mprGetListLength(table->rows);
+        for (rid = 0; rid < nrows && limit > 0; rid++) {
+            if (matchColumns(table, qp, rid) && matched++ >= qp->offset) {
+                count += aggregateCell(&col->cells[rid], op, count, &total);
+                limit--;
             }
-            if (smatch(columnName, "*")) {
-                if (!matchRow(table, row, op, value)) {
-                    matched = 0;
+        }
+    } else if (rows) {
+        for (ITERATE_ITEMS(rows, row, next)) {
+            if (matchQuery(table, qp, row) && matched++ >= qp->offset) {
+                count += aggregateCell(getCell(row, col->cid), op, count, &total);
+                if (--limit <= 0) {
                     break;
                 }
+            }
+        }
+    }
+    unlock(edi);
+    if (op == EDI_AGG_COUNT) {
+        total = count;
+    } else if (op == EDI_AGG_AVG && count > 0) {
+        total /= count;
+    }
+    *result = total;
+    return count;
+}
+
+
+/*
+    Open a cursor for a query. Rows are matched incrementally by mdbNextRec so the result is not a snapshot:
+    rows updated after the cursor is opened are returned with their current values.
+ */
+static int mdbOpenCursor(EdiCursor *cursor, cchar *query)
+{
+    Mdb         *mdb;
+    MdbTable    *table;
+    MdbCursor   *cp;
+    MdbQuery    *qp;
+
+    mdb = (Mdb*) cursor->edi;
+    lock(cursor->edi);
+    if ((table = lookupTable(mdb, cursor->tableName)) == 0) {
+        unlock(cursor->edi);
+        return MPR_ERR_CANT_FIND;
+    }
+    if ((qp = getQuery(mdb, table, query)) == 0) {
+        unlock(cursor->edi);
+        return MPR_ERR_BAD_ARGS;
+    }
+    if ((cp = mprAllocObj(MdbCursor, manageCursor)) == 0) {
+        unlock(cursor->edi);
+        return MPR_ERR_MEMORY;
+    }
+    cp->table = table;
+    cp->query = qp;
+    cp->rows = selectRows(table, qp);
+    cp->skip = qp->offset;
+    cp->limit = qp->limit;
+    cursor->data = cp;
+    unlock(cursor->edi);
+    return 0;
+}
+
+
+static EdiRec *mdbNextRec(EdiCursor *cursor)
+{
+    MdbCursor   *cp;
+    MdbTable    *table;
+    MdbRow      *row;
+    EdiRec      *rec;
+    bool        columnar;
+
+    cp = cursor->data;
+    table = cp->table;
+    rec = 0;
+    lock(cursor->edi);
+    columnar = table->columnar && cp->rows == table->rows;
+    while (!rec && cp->rows && cp->limit > 0 && cp->pos < mprGetListLength(cp->rows)) {
+        if (columnar) {
+            if (matchColumns(table, cp->query, cp->pos)) {
+                row = getRow(table, cp->pos);
             } else {
-                if ((col = lookupField(table, columnName)) == 0) {
-                    unlock(edi);
-                    return 0;
-                }
-                if (!matchCell(col, row->fields[col->cid], op, value)) {
-                    matched = 0;
-                    break;
-                }
+                row = 0;
+            }
+        } else {
+            row = mprGetItem(cp->rows, cp->pos);
+            if (!matchQuery(table, cp->query, row)) {
+                row = 0;
             }
         }
-        if (matched && count++ >= offset) {
-            grid->records[index++] = createRecFromRow(edi, row);
-            grid->nrecords = index;
-            if (--limit <= 0) {
-                break;
+        cp->pos++;
+        if (row) {
+            if (cp->skip > 0) {
+                cp->skip--;
+            } else {
+                rec = createRecFromRow(cursor->edi, row);
+                cp->limit--;
             }
         }
     }
-    unlock(edi);
-    return grid;
+    if (!rec) {
+        /* Count the available records in the same way as mdbFindGrid */
+        cursor->count = mprGetListLength(table->rows);
+    }
+    unlock(cursor->edi);
+    return rec;
+}
+
+
+static void manageCursor(MdbCursor *cp, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(cp->table);
+        mprMark(cp->query);
+        mprMark(cp->rows);
+    }
 }
 
 
@@ -819,10 +1173,6 @@ static int mdbRemoveColumn(Edi *edi, cchar *tableName, cchar *columnName)
         unlock(edi);
         return MPR_ERR_CANT_FIND;
     }
-    if (table->indexCol == col) {
-        table->index = 0;
-        table->indexCol = 0;
-    }
     if (table->keyCol == col) {
         table->keyCol = 0;
     }
@@ -834,16 +1184,23 @@ static int mdbRemoveColumn(Edi *edi, cchar *tableName, cchar *columnName)
     schema->ncols--;
     schema->cols[schema->ncols].name = 0;
     assert(schema->ncols >= 0);
+    table->queries = 0;
     autoSave(mdb, table);
     unlock(edi);
     return 0;
 }
 
 
+/*
+    Remove the index matching the index or column name. If indexName is null, all table indexes are removed.
+ */
 static int mdbRemoveIndex(Edi *edi, cchar *tableName, cchar *indexName)
 {
     Mdb         *mdb;
     MdbTable    *table;
+    MdbSchema   *schema;
+    MdbCol      *col;
+    int         removed;
 
     mdb = (Mdb*) edi;
     lock(edi);
@@ -851,10 +1208,17 @@ static int mdbRemoveIndex(Edi *edi, cchar *tableName, cchar *indexName)
         unlock(edi);
         return MPR_ERR_CANT_FIND;
     }
-    table->index = 0;
-    if (table->indexCol) {
-        table->indexCol->flags &= ~EDI_INDEX;
-        table->indexCol = 0;
+    schema = table->schema;
+    removed = 0;
+    for (col = schema->cols; col < &schema->cols[schema->ncols]; col++) {
+        if (col->index && (indexName == 0 || smatch(col->indexName, indexName) || smatch(col->name, indexName))) {
+            col->index = 0;
+            col->indexName = 0;
+            col->flags &= ~EDI_INDEX;
+            removed++;
+        }
+    }
+    if (removed) {
         autoSave(mdb, table);
     }
     unlock(edi);
@@ -866,8 +1230,7 @@ static int mdbRemoveRec(Edi *edi, cchar *tableName, cchar *key)
 {
     Mdb         *mdb;
     MdbTable    *table;
-    MprKey      *kp;
-    int         r, rc, value;
+    int         r;
 
     assert(edi);
     assert(tableName && *tableName);
@@ -883,19 +1246,10 @@ static int mdbRemoveRec(Edi *edi, cchar *tableName, cchar *key)
         unlock(edi);
         return MPR_ERR_CANT_FIND;
     }
-    rc = mprRemoveItemAtPos(table->rows, r);
-    if (table->index) {
-        mprRemoveKey(table->index, key);
-        for (ITERATE_KEYS(table->index, kp)) {
-            value = (int) PTOL(kp->data);
-            if (value >= r) {
-                mprAddKey(table->index, kp->key, LTOP(value - 1));
-            }
-        }
-    }
-    autoSave(mdb, table);
+    removeRow(table, r);
+    autoSaveRow(mdb, table, "remove", key, 0);
     unlock(edi);
-    return rc;
+    return 0;
 }
 
 
@@ -955,6 +1309,7 @@ static int mdbRenameColumn(Edi *edi, cchar *tableName, cchar *columnName, cchar
         return MPR_ERR_CANT_FIND;
     }
     col->name = sclone(newColumnName);
+    table->queries = 0;
     autoSave(mdb, table);
     unlock(edi);
     return 0;
@@ -987,7 +1342,7 @@ static int mdbUpdateField(Edi *edi, cchar *tableName, cchar *key, cchar *fieldNa
         return MPR_ERR_CANT_FIND;
     }
     updateFieldValue(row, col, value);
-    autoSave(mdb, table);
+    autoSaveRow(mdb, table, "update", key, row);
     unlock(edi);
     return 0;
 }
@@ -1023,7 +1378,7 @@ static int mdbUpdateRec(Edi *edi, EdiRec *rec)
             updateFieldValue(row, col, rec->fields[f].value);
         }
     }
-    autoSave(mdb, table);
+    autoSaveRow(mdb, table, "update", rec->id, row);
     unlock(edi);
     return 0;
 }
@@ -1135,6 +1490,10 @@ static int setMdbValue(MprJsonParser *parser, MprJson *obj, cchar *name, MprJson
     case MDB_LOAD_HINTS:
         if (smatch(name, "ncols")) {
             mdb->loadNcols = atoi(value);
+        } else if (smatch(name, "columnar")) {
+            if (smatch(value, "true")) {
+                mdb->loadTable->columnar = 1;
+            }
         } else {
             mprSetJsonError(parser, "Unknown hint '%s'", name);
             return MPR_ERR_BAD_FORMAT;
@@ -1209,59 +1568,416 @@ static int mdbLoadFromString(Edi *edi, cchar *str)
 }
 
 
-/******************************** Database Saving ****************************/
+/*
+    Binary snapshot format. All integers are little-endian.
+
+        header: magic[4] version:u32 ntables:u32
+        table:  name:str flags:u32 ncols:u32 nrows:u32 col[ncols] row[nrows]
+        col:    name:str type:u32 flags:u32
+        row:    cell[ncols]
+        cell:   type:u8 [value]     Where the value is omitted for nulls, is a u64 for numeric types and a str otherwise
+        str:    len:u32 bytes[len]
+ */
+static uint64 readNum(MdbReader *rp, int size)
+{
+    uint64      value;
+    int         i;
 
-static void autoSave(Mdb *mdb, MdbTable *table)
+    if (rp->error || (rp->end - rp->pos) < size) {
+        rp->error = 1;
+        return 0;
+    }
+    for (value = 0, i = 0; i < size; i++) {
+        value |= ((uint64) rp->pos[i]) << (i * 8);
+    }
+    rp->pos += size;
+    return value;
+}
+
+
+static char *readString(MdbReader *rp)
 {
-    assert(mdb);
+    char        *str;
+    uint        len;
 
-    if (mdb->edi.flags & EDI_NO_SAVE) {
-        return;
+    len = (uint) readNum(rp, 4);
+    if (rp->error || (uint64) (rp->end - rp->pos) < len) {
+        rp->error = 1;
+        return 0;
     }
-    if (mdb->edi.flags & EDI_AUTO_SAVE && !(mdb->edi.flags & EDI_SUPPRESS_SAVE)) {
-        if (mdbSave((Edi*) mdb) < 0) {
-            mprLog("error esp mdb", 0, "Cannot save database %s", mdb->edi.path);
+    str = snclone((cchar*) rp->pos, len);
+    rp->pos += len;
+    return str;
+}
+
+
+static int readCell(MdbReader *rp, MdbCol *col, MdbCell *cell)
+{
+    uint64      bits;
+
+    cell->type = (int) readNum(rp, 1);
+    cell->str = 0;
+    if (IS_NUMERIC_TYPE(cell->type)) {
+        bits = readNum(rp, 8);
+        if (cell->type == EDI_TYPE_FLOAT) {
+            memcpy(&cell->value.fnum, &bits, sizeof(bits));
+        } else {
+            cell->value.inum = (int64) bits;
+            if (col->flags & EDI_AUTO_INC) {
+                col->lastValue = max(col->lastValue, cell->value.inum);
+            }
         }
+    } else if (IS_STRING_TYPE(cell->type)) {
+        cell->str = readString(rp);
+    } else if (cell->type != 0) {
+        rp->error = 1;
     }
+    return rp->error ? MPR_ERR_BAD_FORMAT : 0;
 }
 
 
-static int mdbSave(Edi *edi)
+static int mdbLoadBinary(Mdb *mdb, cchar *data, ssize len)
 {
-    Mdb         *mdb;
-    MdbSchema   *schema;
+    MdbReader   reader, *rp;
     MdbTable    *table;
-    MdbRow      *row;
     MdbCol      *col;
-    cchar       *value, *path, *cp;
-    char        *npath, *bak, *type;
-    MprFile     *out;
-    int         cid, rid, tid, ntables, nrows;
+    MdbRow      *row;
+    MdbCell     *cell;
+    cchar       *name;
+    int         cid, rid, tid, ntables, ncols, nrows, tflags;
 
-    mdb = (Mdb*) edi;
-    if (mdb->edi.flags & EDI_NO_SAVE) {
-        return MPR_ERR_BAD_STATE;
+    rp = &reader;
+    rp->pos = (cuchar*) data + MDB_MAGIC_LEN;
+    rp->end = (cuchar*) data + len;
+    rp->error = 0;
+
+    if (readNum(rp, 4) != MDB_VERSION) {
+        mprLog("error esp mdb", 0, "Unsupported binary database version");
+        return MPR_ERR_BAD_FORMAT;
     }
-    path = mdb->edi.path;
-    if (path == 0) {
-        mprLog("error esp mdb", 0, "Cannot save MDB database in mdbSave, no path specified");
-        return MPR_ERR_BAD_ARGS;
+    mdb->edi.flags |= EDI_SUPPRESS_SAVE;
+    ntables = (int) readNum(rp, 4);
+    for (tid = 0; tid < ntables && !rp->error; tid++) {
+        name = readString(rp);
+        tflags = (int) readNum(rp, 4);
+        ncols = (int) readNum(rp, 4);
+        nrows = (int) readNum(rp, 4);
+        if (rp->error || mdbAddTable((Edi*) mdb, name) < 0) {
+            break;
+        }
+        table = lookupTable(mdb, name);
+        table->columnar = (tflags & MDB_TABLE_COLUMNAR) ? 1 : 0;
+        for (cid = 0; cid < ncols && !rp->error; cid++) {
+            if ((name = readString(rp)) == 0 || (col = createCol(table, name)) == 0) {
+                rp->error = 1;
+                break;
+            }
+            col->type = (int) readNum(rp, 4);
+            col->flags = (int) readNum(rp, 4);
+            if (col->flags & EDI_KEY) {
+                table->keyCol = col;
+            }
+        }
+        for (rid = 0; rid < nrows && !rp->error; rid++) {
+            if ((row = createRow(mdb, table)) == 0) {
+                rp->error = 1;
+                break;
+            }
+            for (cid = 0; cid < ncols; cid++) {
+                if ((cell = getCell(row, cid)) == 0 || readCell(rp, getCol(table, cid), cell) < 0) {
+                    rp->error = 1;
+                    break;
+                }
+            }
+        }
+        /* Create indexes once all rows are loaded */
+        for (cid = 0; cid < ncols && !rp->error; cid++) {
+            col = getCol(table, cid);
+            if (col->flags & EDI_INDEX && createIndex(table, col, NULL) == 0) {
+                rp->error = 1;
+            }
+        }
     }
-    npath = mprReplacePathExt(path, "new");
-    if ((out = mprOpenFile(npath, O_WRONLY | O_TRUNC | O_CREAT | O_BINARY, 0664)) == 0) {
-        mprLog("error esp mdb", 0, "Cannot open database %s", npath);
+    mdb->edi.flags &= ~EDI_SUPPRESS_SAVE;
+    if (rp->error) {
+        mprLog("error esp mdb", 0, "Cannot load database %s, potential corrupt data", mdb->edi.path);
+        return MPR_ERR_BAD_FORMAT;
+    }
+    return 0;
+}
+
+
+/*
+    Map a binary snapshot read-only and load it without first copying the file into memory. Cell strings are
+    cloned while loading, so the mapping is released before returning. Returns MPR_ERR_CANT_FIND if the file is not
+    a binary snapshot or cannot be mapped, in which case the caller reads the file instead.
+ */
+static int mapBinary(Mdb *mdb, cchar *path)
+{
+#if ME_UNIX_LIKE
+    struct stat info;
+    void        *data;
+    ssize       len;
+    int         fd, rc;
+
+    if ((fd = open(path, O_RDONLY | O_BINARY)) < 0) {
+        return MPR_ERR_CANT_FIND;
+    }
+    if (fstat(fd, &info) < 0 || info.st_size < MDB_MAGIC_LEN || info.st_size > MAXSSIZE) {
+        close(fd);
+        return MPR_ERR_CANT_FIND;
+    }
+    len = (ssize) info.st_size;
+    data = mmap(0, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return MPR_ERR_CANT_FIND;
+    }
+    if (memcmp(data, MDB_MAGIC, MDB_MAGIC_LEN) == 0) {
+        rc = mdbLoadBinary(mdb, data, len);
+    } else {
+        rc = MPR_ERR_CANT_FIND;
+    }
+    munmap(data, len);
+    return rc;
+#else
+    return MPR_ERR_CANT_FIND;
+#endif
+}
+
+
+/******************************** Journaling **********************************/
+/*
+    Row changes are appended to a journal file (path.jnl) when auto-saving instead of rewriting the database.
+    Each journal record is a single line of JSON:
+
+        {"op":"update","table":"name","key":"prior-key","row":["value",...]}
+        {"op":"remove","table":"name","key":"key"}
+
+    The journal is replayed after loading the database and is discarded whenever the database is fully saved.
+ */
+
+static int syncFile(MprFile *file)
+{
+    mprFlushFile(file);
+#if ME_WIN_LIKE
+    return _commit(file->fd);
+#else
+    return fsync(file->fd);
+#endif
+}
+
+
+/*
+    Append a row change to the journal. The record is flushed to disk before returning.
+ */
+static int writeJournal(Mdb *mdb, MdbTable *table, cchar *op, cchar *key, MdbRow *row)
+{
+    MprBuf      *buf;
+    MdbCell     *cell;
+    cchar       *value;
+    char        num[MDB_NUM_BUF];
+    ssize       len;
+    int         cid;
+
+    if (mdb->journal == 0) {
+        if ((mdb->journal = mprOpenFile(mprReplacePathExt(mdb->edi.path, "jnl"),
+                O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0664)) == 0) {
+            return MPR_ERR_CANT_OPEN;
+        }
+        mdb->journalSize = mprGetFileSize(mdb->journal);
+    }
+    buf = mprCreateBuf(0, 0);
+    mprPutToBuf(buf, "{\"op\":\"%s\",\"table\":", op);
+    mprFormatJsonString(buf, table->name);
+    if (key) {
+        mprPutStringToBuf(buf, ",\"key\":");
+        mprFormatJsonString(buf, key);
+    }
+    if (row) {
+        mprPutStringToBuf(buf, ",\"row\":[");
+        for (cid = 0; cid < table->schema->ncols; cid++) {
+            if (cid > 0) {
+                mprPutCharToBuf(buf, ',');
+            }
+            cell = getCell(row, cid);
+            if (cell && (value = formatCell(cell, num, sizeof(num))) != 0) {
+                mprFormatJsonString(buf, value);
+            } else {
+                mprPutStringToBuf(buf, "null");
+            }
+        }
+        mprPutCharToBuf(buf, ']');
+    }
+    mprPutStringToBuf(buf, "}\n");
+    len = mprGetBufLength(buf);
+    if (mprWriteFile(mdb->journal, mprGetBufStart(buf), len) != len || syncFile(mdb->journal) < 0) {
+        mprLog("error esp mdb", 0, "Cannot write journal for %s", mdb->edi.path);
+        return MPR_ERR_CANT_WRITE;
+    }
+    mdb->journalSize += len;
+    return 0;
+}
+
+
+/*
+    Apply journal records after loading the database. Replay is idempotent so a journal that was not removed
+    after a full save is safe to apply again. An incomplete final record (from a crash) is ignored.
+ */
+static int replayJournal(Mdb *mdb, cchar *path)
+{
+    MprJson     *obj, *child, *values;
+    MdbTable    *table;
+    MdbRow      *row;
+    MdbCol      *col;
+    cchar       *key, *op;
+    char        *data, *line, *next;
+    int         index, keycol, r;
+
+    if (!mprPathExists(path, R_OK)) {
         return 0;
     }
-    mprEnableFileBuffering(out, 0, 0);
-    mprWriteFileFmt(out, "{\n");
+    if ((data = mprReadPathContents(path, NULL)) == 0) {
+        return MPR_ERR_CANT_READ;
+    }
+    mdb->edi.flags |= EDI_SUPPRESS_SAVE;
+    for (line = stok(data, "\n", &next); line; line = stok(NULL, "\n", &next)) {
+        if ((obj = mprParseJson(line)) == 0) {
+            mprLog("warn esp mdb", 0, "Ignoring incomplete journal record in %s", path);
+            break;
+        }
+        if ((table = lookupTable(mdb, mprGetJson(obj, "table"))) == 0) {
+            continue;
+        }
+        op = mprGetJson(obj, "op");
+        key = mprGetJson(obj, "key");
+        r = key ? lookupRow(table, key) : -1;
+        if (smatch(op, "remove")) {
+            if (r >= 0) {
+                removeRow(table, r);
+            }
+        } else if (smatch(op, "update") && (values = mprGetJsonObj(obj, "row")) != 0) {
+            if (r < 0) {
+                /* Row key may have been changed or assigned by the update */
+                keycol = table->keyCol ? table->keyCol->cid : 0;
+                if ((child = mprGetJsonObj(values, itos(keycol))) != 0 && !(child->type & MPR_JSON_NULL)) {
+                    r = lookupRow(table, child->value);
+                }
+            }
+            if ((row = (r >= 0) ? getRow(table, r) : createRow(mdb, table)) == 0) {
+                break;
+            }
+            for (ITERATE_JSON(values, child, index)) {
+                if ((col = getCol(table, index)) != 0) {
+                    updateFieldValue(row, col, (child->type & MPR_JSON_NULL) ? 0 : child->value);
+                }
+            }
+        }
+    }
+    mdb->edi.flags &= ~EDI_SUPPRESS_SAVE;
+    return 0;
+}
+
+
+/*
+    Discard the journal after a full save
+ */
+static void resetJournal(Mdb *mdb)
+{
+    if (mdb->journal) {
+        mprCloseFile(mdb->journal);
+        mdb->journal = 0;
+    }
+    mdb->journalSize = 0;
+    mprDeletePath(mprReplacePathExt(mdb->edi.path, "jnl"));
+}
+
+/******************************** Database Saving ****************************/
+
+static void autoSave(Mdb *mdb, MdbTable *table)
+{
+    assert(mdb);
+
+    if (mdb->edi.flags & EDI_NO_SAVE) {
+        return;
+    }
+    if (mdb->edi.flags & EDI_AUTO_SAVE && !(mdb->edi.flags & EDI_SUPPRESS_SAVE)) {
+        if (mdbSave((Edi*) mdb) < 0) {
+            mprLog("error esp mdb", 0, "Cannot save database %s", mdb->edi.path);
+        }
+    }
+}
+
+
+/*
+    Auto-save a row change. The change is journaled and the database is only fully saved when the journal is large.
+ */
+static void autoSaveRow(Mdb *mdb, MdbTable *table, cchar *op, cchar *key, MdbRow *row)
+{
+    assert(mdb);
+
+    if (mdb->edi.flags & EDI_NO_SAVE) {
+        return;
+    }
+    if (mdb->edi.flags & EDI_AUTO_SAVE && !(mdb->edi.flags & EDI_SUPPRESS_SAVE)) {
+        if (MDB_JOURNAL_MAX > 0 && writeJournal(mdb, table, op, key, row) == 0 && mdb->journalSize < MDB_JOURNAL_MAX) {
+            return;
+        }
+        if (mdbSave((Edi*) mdb) < 0) {
+            mprLog("error esp mdb", 0, "Cannot save database %s", mdb->edi.path);
+        }
+    }
+}
+
+
+/*
+    Write a value escaping embedded single quotes and backslashes
+ */
+static void writeEscaped(MprFile *out, cchar *value)
+{
+    cchar   *cp, *start;
+
+    for (start = cp = value; *cp; cp++) {
+        if (*cp == '\'' || *cp == '\\') {
+            if (cp > start) {
+                mprWriteFile(out, start, cp - start);
+            }
+            mprWriteFile(out, "\\", 1);
+            start = cp;
+        }
+    }
+    if (cp > start) {
+        mprWriteFile(out, start, cp - start);
+    }
+}
+
+
+/*
+    Write the database as JSON
+ */
+static void writeJson(Mdb *mdb, MprFile *out)
+{
+    MdbSchema   *schema;
+    MdbTable    *table;
+    MdbRow      *row;
+    MdbCol      *col;
+    MdbCell     *cell;
+    cchar       *value;
+    char        *type, buf[MDB_NUM_BUF];
+    int         cid, rid, tid, ntables, nrows;
 
+    mprWriteFileFmt(out, "{\n");
     ntables = mprGetListLength(mdb->tables);
     for (tid = 0; tid < ntables; tid++) {
         table = getTable(mdb, tid);
         schema = table->schema;
         assert(schema);
         mprWriteFileFmt(out, "    '%s': {\n", table->name);
-        mprWriteFileFmt(out, "        hints: {\n            ncols: %d\n        },\n", schema->ncols);
+        mprWriteFileFmt(out, "        hints: {\n            ncols: %d,\n", schema->ncols);
+        if (table->columnar) {
+            mprWriteFileString(out, "            columnar: true,\n");
+        }
+        mprWriteFileString(out, "        },\n");
         mprWriteFileString(out, "        schema: {\n");
         /* Skip the id which is always the first column */
         for (cid = 0; cid < schema->ncols; cid++) {
@@ -1294,32 +2010,26 @@ static int mdbSave(Edi *edi)
             row = getRow(table, rid);
             for (cid = 0; cid < schema->ncols; cid++) {
                 col = getCol(table, cid);
-                value = row->fields[col->cid];
-                if (value == 0 && col->flags & EDI_AUTO_INC) {
-                    row->fields[col->cid] = itos(++col->lastValue);
+                if ((cell = getCell(row, col->cid)) == 0) {
+                    mprWriteFileFmt(out, "null, ");
+                    continue;
+                }
+                if (cell->type == 0 && col->flags & EDI_AUTO_INC) {
+                    updateFieldValue(row, col, 0);
                 }
+                value = formatCell(cell, buf, sizeof(buf));
                 if (value == 0) {
                     mprWriteFileFmt(out, "null, ");
-                } else if (col->type == EDI_TYPE_STRING || col->type == EDI_TYPE_TEXT) {
+                } else if (cell->type == EDI_TYPE_STRING || cell->type == EDI_TYPE_TEXT) {
                     mprWriteFile(out, "'", 1);
                     /*
                         The MPR JSON parser is tolerant of embedded, unquoted control characters. So only need
                         to worry about embedded single quotes and back quote.
                      */
-                    for (cp = value; *cp; cp++) {
-                        if (*cp == '\'' || *cp == '\\') {
-                            mprWriteFile(out, "\\", 1);
-                        }
-                        mprWriteFile(out, cp, 1);
-                    }
+                    writeEscaped(out, value);
                     mprWriteFile(out, "',", 2);
                 } else {
-                    for (cp = value; *cp; cp++) {
-                        if (*cp == '\'' || *cp == '\\') {
-                            mprWriteFile(out, "\\", 1);
-                        }
-                        mprWriteFile(out, cp, 1);
-                    }
+                    writeEscaped(out, value);
                     mprWriteFile(out, ",", 1);
                 }
             }
@@ -1328,6 +2038,118 @@ static int mdbSave(Edi *edi)
         mprWriteFileString(out, "        ],\n    },\n");
     }
     mprWriteFileString(out, "}\n");
+}
+
+
+static void writeNum(MprFile *out, uint64 value, int size)
+{
+    uchar   buf[8];
+    int     i;
+
+    for (i = 0; i < size; i++) {
+        buf[i] = (uchar) (value >> (i * 8));
+    }
+    mprWriteFile(out, buf, size);
+}
+
+
+static void writeString(MprFile *out, cchar *str, ssize len)
+{
+    writeNum(out, (uint64) len, 4);
+    mprWriteFile(out, str, len);
+}
+
+
+/*
+    Write the database in the binary snapshot format. See mdbLoadBinary for the layout.
+ */
+static void writeBinary(Mdb *mdb, MprFile *out)
+{
+    MdbSchema   *schema;
+    MdbTable    *table;
+    MdbRow      *row;
+    MdbCol      *col;
+    MdbCell     *cell;
+    uint64      bits;
+    int         cid, rid, tid, ntables, nrows;
+
+    mprWriteFile(out, MDB_MAGIC, MDB_MAGIC_LEN);
+    writeNum(out, MDB_VERSION, 4);
+    ntables = mprGetListLength(mdb->tables);
+    writeNum(out, ntables, 4);
+
+    for (tid = 0; tid < ntables; tid++) {
+        table = getTable(mdb, tid);
+        schema = table->schema;
+        nrows = mprGetListLength(table->rows);
+        writeString(out, table->name, slen(table->name));
+        writeNum(out, table->columnar ? MDB_TABLE_COLUMNAR : 0, 4);
+        writeNum(out, schema->ncols, 4);
+        writeNum(out, nrows, 4);
+        for (cid = 0; cid < schema->ncols; cid++) {
+            col = getCol(table, cid);
+            writeString(out, col->name, slen(col->name));
+            writeNum(out, col->type, 4);
+            writeNum(out, col->flags, 4);
+        }
+        for (rid = 0; rid < nrows; rid++) {
+            row = getRow(table, rid);
+            for (cid = 0; cid < schema->ncols; cid++) {
+                col = getCol(table, cid);
+                if ((cell = getCell(row, cid)) == 0) {
+                    writeNum(out, 0, 1);
+                    continue;
+                }
+                if (cell->type == 0 && col->flags & EDI_AUTO_INC) {
+                    updateFieldValue(row, col, 0);
+                }
+                writeNum(out, cell->type, 1);
+                if (cell->type == EDI_TYPE_FLOAT) {
+                    memcpy(&bits, &cell->value.fnum, sizeof(bits));
+                    writeNum(out, bits, 8);
+                } else if (IS_NUMERIC_TYPE(cell->type)) {
+                    writeNum(out, (uint64) cell->value.inum, 8);
+                } else if (IS_STRING_TYPE(cell->type)) {
+                    writeString(out, cell->str, slen(cell->str));
+                }
+            }
+        }
+    }
+}
+
+
+static int mdbSave(Edi *edi)
+{
+    Mdb         *mdb;
+    cchar       *path;
+    char        *npath, *bak;
+    MprFile     *out;
+
+    mdb = (Mdb*) edi;
+    if (mdb->edi.flags & EDI_NO_SAVE) {
+        return MPR_ERR_BAD_STATE;
+    }
+    path = mdb->edi.path;
+    if (path == 0) {
+        mprLog("error esp mdb", 0, "Cannot save MDB database in mdbSave, no path specified");
+        return MPR_ERR_BAD_ARGS;
+    }
+    npath = mprReplacePathExt(path, "new");
+    if ((out = mprOpenFile(npath, O_WRONLY | O_TRUNC | O_CREAT | O_BINARY, 0664)) == 0) {
+        mprLog("error esp mdb", 0, "Cannot open database %s", npath);
+        return 0;
+    }
+    mprEnableFileBuffering(out, 0, 0);
+    if (mdb->edi.flags & EDI_BINARY || smatch(mprGetPathExt(path), MDB_BINARY_EXT)) {
+        writeBinary(mdb, out);
+    } else {
+        writeJson(mdb, out);
+    }
+    if (syncFile(out) < 0) {
+        mprLog("error esp mdb", 0, "Cannot flush database %s", npath);
+        mprCloseFile(out);
+        return MPR_ERR_CANT_WRITE;
+    }
     mprCloseFile(out);
 
     bak = mprReplacePathExt(path, "bak");
@@ -1342,6 +2164,7 @@ static int mdbSave(Edi *edi)
         rename(bak, path);
         return MPR_ERR_CANT_WRITE;
     }
+    resetJournal(mdb);
     return 0;
 }
 
@@ -1381,10 +2204,10 @@ static void manageTable(MdbTable *table, int flags)
     if (flags & MPR_MANAGE_MARK) {
         mprMark(table->name);
         mprMark(table->schema);
-        mprMark(table->index);
         mprMark(table->rows);
+        mprMark(table->queries);
         /*
-            Do not mark keyCol or indexCol - they are unmanaged
+            Do not mark keyCol - it is unmanaged
          */
     }
 }
@@ -1392,20 +2215,27 @@ static void manageTable(MdbTable *table, int flags)
 
 static int lookupRow(MdbTable *table, cchar *key)
 {
-    MprKey      *kp;
+    MdbCol      *col;
     MdbRow      *row;
+    MdbCell     cell, *kcell;
+    MprList     *rows;
+    char        buf[MDB_NUM_BUF];
     int         nrows, r, keycol;
 
-    if (table->index) {
-        if ((kp = mprLookupKeyEntry(table->index, key)) != 0) {
-            return (int) PTOL(kp->data);
+    keycol = table->keyCol ? table->keyCol->cid : 0;
+    if ((col = getCol(table, keycol)) == 0) {
+        return -1;
+    }
+    parseCell(&cell, col->type, key);
+    if (col->index) {
+        if ((rows = lookupIndex(col, formatCell(&cell, buf, sizeof(buf)))) != 0 && (row = mprGetFirstItem(rows)) != 0) {
+            return row->rid;
         }
     } else {
         nrows = mprGetListLength(table->rows);
-        keycol = table->keyCol ? table->keyCol->cid : 0;
         for (r = 0; r < nrows; r++) {
             row = mprGetItem(table->rows, r);
-            if (smatch(row->fields[keycol], key)) {
+            if ((kcell = getCell(row, keycol)) != 0 && compareCells(kcell, &cell) == 0) {
                 return r;
             }
         }
@@ -1452,6 +2282,9 @@ static MdbCol *createCol(MdbTable *table, cchar *columnName)
     col = &schema->cols[schema->ncols];
     col->cid = schema->ncols++;
     col->name = sclone(columnName);
+    if (table->columnar && growCells(col, mprGetListLength(table->rows)) < 0) {
+        return 0;
+    }
     return col;
 }
 
@@ -1470,12 +2303,40 @@ static void manageSchema(MdbSchema *schema, int flags)
 
 static void manageCol(MdbCol *col, int flags)
 {
+    MdbCell     *cell;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(col->name);
+        mprMark(col->indexName);
+        mprMark(col->index);
+        mprMark(col->cells);
+        for (cell = col->cells; cell && cell < &col->cells[col->ncells]; cell++) {
+            mprMark(cell->str);
+        }
     }
 }
 
 
+/*
+    Set the number of cells in a columnar cell array, growing the array as required
+ */
+static int growCells(MdbCol *col, int ncells)
+{
+    int     capacity;
+
+    if (ncells > col->maxCells) {
+        capacity = max(ncells, max(col->maxCells * 2, MDB_INCR));
+        if ((col->cells = mprRealloc(col->cells, capacity * sizeof(MdbCell))) == 0) {
+            return MPR_ERR_MEMORY;
+        }
+        memset(&col->cells[col->maxCells], 0, (capacity - col->maxCells) * sizeof(MdbCell));
+        col->maxCells = capacity;
+    }
+    col->ncells = ncells;
+    return 0;
+}
+
+
 static MdbCol *getCol(MdbTable *table, int col)
 {
     if (col < 0 || col >= table->schema->ncols) {
@@ -1502,15 +2363,126 @@ static MdbCol *lookupField(MdbTable *table, cchar *columnName)
 }
 
 
+/********************************* Index Operations ************************/
+/*
+    Create a value index for a column and index the existing rows
+ */
+static MprHash *createIndex(MdbTable *table, MdbCol *col, cchar *indexName)
+{
+    MdbRow      *row;
+    int         next;
+
+    if ((col->index = mprCreateHash(0, MPR_HASH_STABLE)) == 0) {
+        return 0;
+    }
+    col->indexName = sclone(indexName ? indexName : col->name);
+    col->flags |= EDI_INDEX;
+    for (ITERATE_ITEMS(table->rows, row, next)) {
+        indexRow(col, row);
+    }
+    return col->index;
+}
+
+
+/*
+    Return the position in an index row list for the given rid (or where it should be inserted)
+ */
+static int findIndexPos(MprList *rows, int rid)
+{
+    MdbRow      *row;
+    int         low, high, mid;
+
+    low = 0;
+    high = mprGetListLength(rows);
+    while (low < high) {
+        mid = (low + high) / 2;
+        row = mprGetItem(rows, mid);
+        if (row->rid < rid) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+
+static MprList *lookupIndex(MdbCol *col, cchar *value)
+{
+    if (col->index == 0 || value == 0) {
+        return 0;
+    }
+    return mprLookupKey(col->index, value);
+}
+
+
+static void indexRow(MdbCol *col, MdbRow *row)
+{
+    MdbCell     *cell;
+    MprList     *rows;
+    cchar       *value;
+    char        buf[MDB_NUM_BUF];
+
+    if ((cell = getCell(row, col->cid)) == 0 || (value = formatCell(cell, buf, sizeof(buf))) == 0) {
+        return;
+    }
+    if ((rows = lookupIndex(col, value)) == 0) {
+        if ((rows = mprCreateList(0, MPR_LIST_STABLE)) == 0) {
+            return;
+        }
+        mprAddKey(col->index, value, rows);
+    }
+    mprInsertItemAtPos(rows, findIndexPos(rows, row->rid), row);
+}
+
+
+static void unindexRow(MdbCol *col, MdbRow *row)
+{
+    MdbCell     *cell;
+    MprList     *rows;
+    cchar       *value;
+    char        buf[MDB_NUM_BUF];
+    int         pos;
+
+    if ((cell = getCell(row, col->cid)) == 0 || (value = formatCell(cell, buf, sizeof(buf))) == 0) {
+        return;
+    }
+    if ((rows = lookupIndex(col, value)) == 0) {
+        return;
+    }
+    pos = findIndexPos(rows, row->rid);
+    if (mprGetItem(rows, pos) == row) {
+        mprRemoveItemAtPos(rows, pos);
+    }
+    if (mprGetListLength(rows) == 0) {
+        mprRemoveKey(col->index, value);
+    }
+}
+
 /********************************* Row Operations **************************/
 
+/*
+    Create a row. Columnar tables store the row cells in the column cell arrays.
+ */
 static MdbRow *createRow(Mdb *mdb, MdbTable *table)
 {
     MdbRow      *row;
+    MdbSchema   *schema;
+    MdbCol      *col;
     int         ncols;
 
-    ncols = max(table->schema->ncols, 1);
-    if ((row = mprAllocBlock(sizeof(MdbRow) + sizeof(EdiField) * ncols, MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO)) == 0) {
+    schema = table->schema;
+    if (table->columnar) {
+        for (col = schema->cols; col < &schema->cols[schema->ncols]; col++) {
+            if (growCells(col, mprGetListLength(table->rows) + 1) < 0) {
+                return 0;
+            }
+        }
+        ncols = 0;
+    } else {
+        ncols = max(schema->ncols, 1);
+    }
+    if ((row = mprAllocBlock(sizeof(MdbRow) + sizeof(MdbCell) * ncols, MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO)) == 0) {
         return 0;
     }
     mprSetManager(row, (MprManager) manageRow);
@@ -1528,12 +2500,73 @@ static void manageRow(MdbRow *row, int flags)
     if (flags & MPR_MANAGE_MARK) {
         mprMark(row->table);
         for (fid = 0; fid < row->nfields; fid++) {
-            mprMark(row->fields[fid]);
+            mprMark(row->fields[fid].str);
         }
     }
 }
 
 
+/*
+    Remove a row and renumber the following rows
+ */
+static void removeRow(MdbTable *table, int r)
+{
+    MdbSchema   *schema;
+    MdbCol      *col;
+    MdbRow      *row;
+    int         nrows;
+
+    if ((row = getRow(table, r)) == 0) {
+        return;
+    }
+    schema = table->schema;
+    for (col = schema->cols; col < &schema->cols[schema->ncols]; col++) {
+        if (col->index) {
+            unindexRow(col, row);
+        }
+    }
+    mprRemoveItemAtPos(table->rows, r);
+    nrows = mprGetListLength(table->rows);
+    if (table->columnar) {
+        for (col = schema->cols; col < &schema->cols[schema->ncols]; col++) {
+            if (r < col->ncells) {
+                memmove(&col->cells[r], &col->cells[r + 1], (col->ncells - r - 1) * sizeof(MdbCell));
+                memset(&col->cells[--col->ncells], 0, sizeof(MdbCell));
+            }
+        }
+    }
+
+    /*
+        Renumber the following rows. This preserves the rid ordering of the index row lists.
+     */
+    for (; r < nrows; r++) {
+        row = mprGetItem(table->rows, r);
+        row->rid = r;
+    }
+}
+
+
+/*
+    Get a row cell. Returns null if the row does not have the column.
+ */
+static MdbCell *getCell(MdbRow *row, int cid)
+{
+    MdbTable    *table;
+
+    table = row->table;
+    if (table->columnar) {
+        if (cid < 0 || cid >= table->schema->ncols || row->rid >= table->schema->cols[cid].ncells) {
+            return 0;
+        }
+        return &table->schema->cols[cid].cells[row->rid];
+    }
+    if (cid < 0 || cid >= row->nfields) {
+        return 0;
+    }
+    return &row->fields[cid];
+}
+
+
 static MdbRow *getRow(MdbTable *table, int rid)
 {
     int     nrows;
@@ -1547,68 +2580,206 @@ static MdbRow *getRow(MdbTable *table, int rid)
 
 /********************************* Field Operations ************************/
 
-static cchar *mapMdbValue(cchar *value, int type)
+/*
+    Convert a string value to a cell of the given type. Values that cannot be converted are stored as strings.
+    WARNING: string values are not cloned.
+ */
+static void parseCell(MdbCell *cell, int type, cchar *value)
 {
-    MprTime     time;
+    MprTime     when;
+    double      fnum;
+    char        *end;
 
+    cell->str = 0;
     if (value == 0) {
-        return value;
+        cell->type = 0;
+        return;
     }
     switch (type) {
     case EDI_TYPE_DATE:
         if (!snumber(value)) {
-            mprParseTime(&time, value, MPR_UTC_TIMEZONE, 0);
-            value = itos(time);
+            if (mprParseTime(&when, value, MPR_UTC_TIMEZONE, 0) == 0) {
+                cell->type = type;
+                cell->value.inum = when;
+                return;
+            }
+            break;
+        }
+        /* Fall through */
+
+    case EDI_TYPE_INT:
+        if (snumber(value) && *value != '+') {
+            cell->type = type;
+            cell->value.inum = stoi(value);
+            return;
         }
         break;
 
     case EDI_TYPE_BOOL:
-        if (smatch(value, "false")) {
-            value = "0";
-        } else if (smatch(value, "true")) {
-            value = "1";
+        if (smatch(value, "true") || smatch(value, "1")) {
+            cell->type = type;
+            cell->value.inum = 1;
+            return;
+        } else if (smatch(value, "false") || smatch(value, "0")) {
+            cell->type = type;
+            cell->value.inum = 0;
+            return;
         }
         break;
 
-    case EDI_TYPE_BINARY:
     case EDI_TYPE_FLOAT:
-    case EDI_TYPE_INT:
+        /*
+            Accept signed and leading-dot values. The entire value must be numeric.
+         */
+        if (*value && !isspace((uchar) *value)) {
+            fnum = strtod(value, &end);
+            if (*end == '\0') {
+                cell->type = type;
+                cell->value.fnum = fnum;
+                return;
+            }
+        }
+        break;
+
+    case EDI_TYPE_BINARY:
     case EDI_TYPE_STRING:
     case EDI_TYPE_TEXT:
+        cell->type = type;
+        cell->str = value;
+        return;
+    }
+    cell->type = EDI_TYPE_STRING;
+    cell->str = value;
+}
+
+
+/*
+    Add a cell value to an aggregate of count prior values. Returns 1 if the value is aggregated. Nulls and string
+    values that are not numeric are ignored.
+ */
+static int aggregateCell(MdbCell *cell, int op, int count, double *total)
+{
+    double      num;
+    char        *end;
+
+    if (cell == 0 || cell->type == 0) {
+        return 0;
+    }
+    if (cell->type == EDI_TYPE_FLOAT) {
+        num = cell->value.fnum;
+    } else if (IS_NUMERIC_TYPE(cell->type)) {
+        num = (double) cell->value.inum;
+    } else {
+        if (!cell->str || *cell->str == '\0' || isspace((uchar) *cell->str)) {
+            return 0;
+        }
+        num = strtod(cell->str, &end);
+        if (*end != '\0') {
+            return 0;
+        }
+    }
+    if (op == EDI_AGG_MIN) {
+        *total = (count == 0 || num < *total) ? num : *total;
+    } else if (op == EDI_AGG_MAX) {
+        *total = (count == 0 || num > *total) ? num : *total;
+    } else {
+        *total += num;
+    }
+    return 1;
+}
+
+
+/*
+    Return the string form of a cell. Numeric values are formatted into the supplied buffer.
+ */
+static cchar *formatCell(MdbCell *cell, char *buf, ssize bufsize)
+{
+    switch (cell->type) {
+    case 0:
+        return 0;
+
+    case EDI_TYPE_BOOL:
+    case EDI_TYPE_DATE:
+    case EDI_TYPE_INT:
+        return itosbuf(buf, bufsize, cell->value.inum, 10);
+
+    case EDI_TYPE_FLOAT:
+        /* Use the shortest precision that preserves the value */
+        fmt(buf, bufsize, "%.15g", cell->value.fnum);
+        if (stof(buf) != cell->value.fnum) {
+            fmt(buf, bufsize, "%.17g", cell->value.fnum);
+        }
+        return buf;
+
     default:
-        break;
+        return cell->str;
+    }
+}
+
+
+/*
+    Return the string form of a cell. String values are not cloned. The string form of numeric values is formatted
+    on first use and cached in the cell.
+ */
+static cchar *getCellString(MdbCell *cell)
+{
+    char    buf[MDB_NUM_BUF];
+
+    if (IS_NUMERIC_TYPE(cell->type) && !cell->str) {
+        cell->str = sclone(formatCell(cell, buf, sizeof(buf)));
+    }
+    return cell->str;
+}
+
+
+/*
+    Compare two cells. Numeric cells are compared numerically, otherwise the string forms are compared.
+ */
+static int compareCells(MdbCell *c1, MdbCell *c2)
+{
+    char    b1[MDB_NUM_BUF], b2[MDB_NUM_BUF];
+    double  d1, d2;
+
+    if (IS_NUMERIC_TYPE(c1->type) && IS_NUMERIC_TYPE(c2->type)) {
+        if (c1->type == EDI_TYPE_FLOAT || c2->type == EDI_TYPE_FLOAT) {
+            d1 = (c1->type == EDI_TYPE_FLOAT) ? c1->value.fnum : (double) c1->value.inum;
+            d2 = (c2->type == EDI_TYPE_FLOAT) ? c2->value.fnum : (double) c2->value.inum;
+            return (d1 < d2) ? -1 : ((d1 > d2) ? 1 : 0);
+        }
+        return (c1->value.inum < c2->value.inum) ? -1 : ((c1->value.inum > c2->value.inum) ? 1 : 0);
     }
-    return sclone(value);
+    return scmp(formatCell(c1, b1, sizeof(b1)), formatCell(c2, b2, sizeof(b2)));
 }
 
+
 static int updateFieldValue(MdbRow *row, MdbCol *col, cchar *value)
 {
-    MdbTable    *table;
-    cchar       *key;
+    MdbCell     *cell;
 
     assert(row);
     assert(col);
 
-    table = row->table;
-    if (col->flags & EDI_INDEX) {
-        if ((key = row->fields[col->cid]) != 0) {
-            mprRemoveKey(table->index, key);
-        }
-    } else {
-        key = 0;
+    if (col->index) {
+        unindexRow(col, row);
     }
-    if (col->flags & EDI_AUTO_INC) {
-        if (value == 0) {
-            row->fields[col->cid] = value = itos(++col->lastValue);
-        } else {
-            row->fields[col->cid] = sclone(value);
+    if ((cell = getCell(row, col->cid)) == 0) {
+        return MPR_ERR_BAD_ARGS;
+    }
+    if (col->flags & EDI_AUTO_INC && value == 0) {
+        cell->type = EDI_TYPE_INT;
+        cell->str = 0;
+        cell->value.inum = ++col->lastValue;
+    } else {
+        parseCell(cell, col->type, value);
+        if (IS_STRING_TYPE(cell->type)) {
+            cell->str = sclone(value);
+        }
+        if (col->flags & EDI_AUTO_INC) {
             col->lastValue = max(col->lastValue, (int64) stoi(value));
         }
-    } else {
-        row->fields[col->cid] = mapMdbValue(value, col->type);
     }
-    if (col->flags & EDI_INDEX && value) {
-        mprAddKey(table->index, value, LTOP(row->rid));
+    if (col->index) {
+        indexRow(col, row);
     }
     return 0;
 }
@@ -1621,20 +2792,21 @@ static EdiRec *createRecFromRow(Edi *edi, MdbRow *row)
 {
     EdiRec  *rec;
     MdbCol  *col;
-    int     c;
+    int     c, nfields;
 
-    if ((rec = mprAllocBlock(sizeof(EdiRec) + sizeof(EdiField) * row->nfields, MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO)) == 0) {
+    nfields = row->table->columnar ? max(row->table->schema->ncols, 1) : row->nfields;
+    if ((rec = mprAllocBlock(sizeof(EdiRec) + sizeof(EdiField) * nfields, MPR_ALLOC_MANAGER | MPR_ALLOC_ZERO)) == 0) {
         return 0;
     }
     mprSetManager(rec, (MprManager) ediManageEdiRec);
     rec->edi = edi;
     rec->tableName = row->table->name;
-    rec->id = row->fields[0];
-    rec->nfields = row->nfields;
-    for (c = 0; c < row->nfields; c++) {
+    rec->nfields = nfields;
+    for (c = 0; c < nfields; c++) {
         col = getCol(row->table, c);
         rec->fields[c] = makeFieldFromRow(row, col);
     }
+    rec->id = rec->fields[0].value;
     return rec;
 }
 
@@ -1651,8 +2823,8 @@ static int parseOperation(cchar *operation)
         }
         break;
     case '!':
-        if (smatch(operation, "=!")) {
-            return OP_EQ;
+        if (smatch(operation, "!=")) {
+            return OP_NEQ;
         }
         break;
     case '<':
@@ -25,13 +25,21 @@ extern "C" {
 
 /********************************** Tunables **********************************/
 
-#define MDB_INCR    8                   /**< Default memory allocation increment for MDB */
+#define MDB_INCR            8           /**< Default memory allocation increment for MDB */
+#define MDB_QUERY_CACHE     32          /**< Max compiled queries cached per table. Set to zero to disable */
+#define MDB_JOURNAL_MAX     (1024 * 1024) /**< Journal size that triggers a full save. Set to zero to disable journaling */
+#define MDB_BINARY_EXT      "mdbx"      /**< Database path extension that selects the binary snapshot format */
 
 /*
     Per column structure
  */
 typedef struct MdbCol {
     char            *name;              /* Column name */
+    char            *indexName;         /* Index name if indexed */
+    MprHash         *index;             /* Column value index. Map of value to MprList of MdbRow, ordered by rid */
+    struct MdbCell  *cells;             /* Cell values indexed by rid (columnar tables only) */
+    int             ncells;             /* Number of cells in use */
+    int             maxCells;           /* Capacity of cells */
     int             type;               /* Column type */
     int             flags;              /* Column flags */
     int             cid;                /* Column index in MdbSchema.cols */
@@ -47,26 +55,74 @@ typedef struct MdbSchema {
     MdbCol          cols[ARRAY_FLEX];   /* Array of columns */
 } MdbSchema;
 
+/*
+    Per cell value. Integer, boolean, date and floating point values are stored in binary form.
+    Values that cannot be converted to the column type are stored as strings.
+    The string form of a numeric value is created when first read and cached until the value changes.
+ */
+typedef struct MdbCell {
+    int             type;               /* Value type (EDI_TYPE_*). Set to zero if null */
+    cchar           *str;               /* Binary, string and text values. Cached string form of numeric values */
+    union {
+        int64       inum;               /* Integer, boolean and date values */
+        double      fnum;               /* Floating point values */
+    } value;
+} MdbCell;
+
 /*
     Per row structure
  */
 typedef struct MdbRow {
     struct MdbTable *table;             /* Reference to MdbTable */
     int             rid;                /* Table index in MdbTable.row */
-    int             nfields;            /* Number of fields in fields */
-    cchar           *fields[ARRAY_FLEX];/* All data stored as strings */
+    int             nfields;            /* Number of fields in fields. Zero for columnar tables */
+    MdbCell         fields[ARRAY_FLEX]; /* Field values */
 } MdbRow;
 
+/*
+    Compiled query expression term
+ */
+typedef struct MdbTerm {
+    int             cid;                /* Column index or -1 to match any column */
+    int             op;                 /* Comparison operation */
+    cchar           *value;             /* Comparison value */
+    MdbCell         cell;               /* Comparison value converted to the column type */
+} MdbTerm;
+
+/*
+    Compiled query. Terms are ANDed together.
+ */
+typedef struct MdbQuery {
+    char            *source;            /* Parsed query text. Term values refer into this buffer */
+    int64           used;               /* Sequence number of last use for LRU eviction */
+    int             offset;             /* Offset of first matching row to return */
+    int             limit;              /* Maximum number of rows to return */
+    int             nterms;             /* Number of terms */
+    MdbTerm         terms[ARRAY_FLEX];  /* Query terms */
+} MdbQuery;
+
+/*
+    Cursor state for a query. Rows are visited in table order.
+ */
+typedef struct MdbCursor {
+    struct MdbTable *table;             /* Table being queried */
+    MdbQuery        *query;             /* Compiled query */
+    MprList         *rows;              /* Candidate rows. Null if no row can match */
+    int             pos;                /* Index of the next candidate row */
+    int             skip;               /* Matching rows still to skip for the query offset */
+    int             limit;              /* Matching rows still to return */
+} MdbCursor;
+
 /*
     Per table structure
  */
 typedef struct MdbTable {
     char            *name;              /* Table name */
     MdbSchema       *schema;            /* Table columns schema */
-    MprHash         *index;             /* Table index */
     MdbCol          *keyCol;            /* Reference to the key column (unmanaged) */
-    MdbCol          *indexCol;          /* Reference to the index column (unmanaged) */
     MprList         *rows;              /* Table row */
+    MprHash         *queries;           /* Cache of compiled queries indexed by query string */
+    bool            columnar;           /* Cells are stored in per-column arrays (MdbCol.cells) */
 } MdbTable;
 
 /*
@@ -80,6 +136,9 @@ typedef struct MdbTable {
 typedef struct Mdb {
     Edi             edi;                /**< EDI database interface structure */
     MprList         *tables;            /**< List of tables */
+    MprFile         *journal;           /**< Auto-save journal of row changes */
+    MprOff          journalSize;        /**< Current size of the journal */
+    int64           querySeq;           /**< Query sequence number for compiled query LRU */
 
     /*
         When loading from file only (do not mark)
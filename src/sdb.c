@@ -18,15 +18,68 @@
 #ifndef ME_MAX_SQLITE_DURATION
     #define ME_MAX_SQLITE_DURATION 30000           /**< Database busy timeout */
 #endif
+#ifndef ME_MAX_SQLITE_STATEMENTS
+    #define ME_MAX_SQLITE_STATEMENTS 64            /**< Max cached prepared statements per connection. Zero to disable */
+#endif
+#ifndef ME_MAX_SQLITE_READERS
+    #define ME_MAX_SQLITE_READERS  8               /**< Max read-only connections per database */
+#endif
+#ifndef ME_MAX_SQLITE_KEYS
+    #define ME_MAX_SQLITE_KEYS     256             /**< Max keys read per query by ediReadRecs */
+#endif
 
 /************************************* Local **********************************/
+/*
+    SQLite connection. The writer connection is used for all updates. Read-only connections are used for
+    SELECT queries when the database is in WAL mode so that readers do not wait on each other or the writer.
+ */
+typedef struct SdbConn {
+    sqlite3         *db;            /**< SQLite database handle */
+    MprHash         *statements;    /**< Cache of prepared statements indexed by SQL command */
+    bool            inUse;          /**< Read connection is in use by a query */
+    bool            stale;          /**< Statement cache must be cleared when the connection is released */
+} SdbConn;
 
 typedef struct Sdb {
     Edi             edi;            /**< EDI database interface structure */
-    sqlite3         *db;            /**< SQLite database handle */
+    SdbConn         writer;         /**< Connection for updates and schema changes */
+    SdbConn         readers[ME_MAX_SQLITE_READERS]; /**< Pool of read-only connections */
+    int             maxReaders;     /**< Number of read connections to use */
+    bool            wal;            /**< Database is in WAL journal mode */
     MprHash         *schemas;       /**< Table schemas */
+    MprList         *cursors;       /**< Open cursors. Released when the database is closed */
+    int64           statementSeq;   /**< Statement sequence number for the statement cache LRU */
+    cchar           *synchronous;   /**< Synchronous pragma setting */
+    int64           cacheSize;      /**< Connection page cache size in bytes */
+    int64           mmapSize;       /**< Connection memory map size in bytes */
 } Sdb;
 
+/*
+    Cached prepared statement
+ */
+typedef struct SdbStatement {
+    sqlite3_stmt    *stmt;          /**< SQLite prepared statement */
+    int64           used;           /**< Sequence number when last used */
+    bool            inUse;          /**< Statement is currently executing */
+    bool            stale;          /**< Statement was removed from the cache while in use */
+} SdbStatement;
+
+/*
+    Cursor state. The cursor holds its connection and statement until closed. Open cursors are owned by the database
+    and are released by sdbClose if not closed before.
+ */
+typedef struct SdbCursor {
+    Sdb             *sdb;           /**< Owning database */
+    SdbConn         *conn;          /**< Connection running the statement */
+    SdbStatement    *sp;            /**< Cached statement. Null if not cached */
+    sqlite3_stmt    *stmt;          /**< SQLite prepared statement */
+    cchar           *defaultTableName; /**< Table name of the first row */
+    int             ncol;           /**< Number of result columns */
+    int             offset;         /**< Query offset */
+    int             limit;          /**< Query limit */
+    int             nrecords;       /**< Number of records read */
+} SdbCursor;
+
 static int sqliteInitialized;
 static void initSqlite(void);
 
@@ -62,20 +115,37 @@ static char *dataTypeToSqlType[] = {
 
 /************************************ Forwards ********************************/
 
+static SdbConn *acquireConn(Sdb *sdb, cchar *cmd);
+static SdbStatement *addStatement(Sdb *sdb, SdbConn *conn, cchar *cmd, sqlite3_stmt *stmt);
+static void applyPragmas(Sdb *sdb, sqlite3 *db);
+static void clearConnStatements(SdbConn *conn);
+static void clearStatements(Edi *edi);
+static void closeConn(SdbConn *conn);
+static void closeConns(Sdb *sdb);
+static char *buildFindQuery(Edi *edi, cchar *tableName, cchar *select, int *argc, cchar ***argv, int *offset, int *limit);
 static EdiRec *createBareRec(Edi *edi, cchar *tableName, int nfields);
+static EdiRec *createRecFromStmt(Edi *edi, sqlite3_stmt *stmt, int ncol, cchar **defaultTableName);
+static SdbStatement *getStatement(Sdb *sdb, SdbConn *conn, cchar *cmd);
 static EdiField makeRecField(cchar *value, cchar *name, int type);
 static void manageSdb(Sdb *sdb, int flags);
+static void manageSdbCursor(SdbCursor *cp, int flags);
 static int mapSqliteTypeToEdiType(int type);
 static cchar *mapToSqlType(int type);
 static int mapToEdiType(cchar *type);
 static EdiGrid *query(Edi *edi, cchar *cmd, ...);
 static EdiGrid *queryArgv(Edi *edi, cchar *cmd, int argc, cchar **argv, ...);
+static void releaseConn(Sdb *sdb, SdbConn *conn);
+static void releaseCursor(SdbCursor *cp);
+static int releaseStatement(Sdb *sdb, SdbConn *conn, SdbStatement *sp, sqlite3_stmt *stmt);
+static void setJournalMode(Sdb *sdb, cchar *mode);
 static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list args);
 static int sdbAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type, int flags);
 static int sdbAddIndex(Edi *edi, cchar *tableName, cchar *columnName, cchar *indexName);
 static int sdbAddTable(Edi *edi, cchar *tableName);
 static int sdbChangeColumn(Edi *edi, cchar *tableName, cchar *columnName, int type, int flags);
 static void sdbClose(Edi *edi);
+static void sdbCloseCursor(EdiCursor *cursor);
+static int sdbConfigure(Edi *edi, MprJson *options);
 static EdiRec *sdbCreateRec(Edi *edi, cchar *tableName);
 static int sdbDelete(cchar *path);
 static void sdbError(Edi *edi, cchar *fmt, ...);
@@ -86,10 +156,13 @@ static int sdbGetColumnSchema(Edi *edi, cchar *tableName, cchar *columnName, int
 static MprList *sdbGetTables(Edi *edi);
 static int sdbGetTableDimensions(Edi *edi, cchar *tableName, int *numRows, int *numCols);
 static int sdbLookupField(Edi *edi, cchar *tableName, cchar *fieldName);
+static EdiRec *sdbNextRec(EdiCursor *cursor);
 static Edi *sdbOpen(cchar *path, int flags);
+static int sdbOpenCursor(EdiCursor *cursor, cchar *query);
 PUBLIC EdiGrid *sdbQuery(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list vargs);
 static EdiField sdbReadField(Edi *edi, cchar *tableName, cchar *key, cchar *fieldName);
 static EdiRec *sdbReadRecByKey(Edi *edi, cchar *tableName, cchar *key);
+static EdiGrid *sdbReadRecs(Edi *edi, cchar *tableName, int argc, cchar **keys);
 static int sdbRemoveColumn(Edi *edi, cchar *tableName, cchar *columnName);
 static int sdbRemoveIndex(Edi *edi, cchar *tableName, cchar *indexName);
 static int sdbRemoveTable(Edi *edi, cchar *tableName);
@@ -106,7 +179,8 @@ static EdiProvider SdbProvider = {
     sdbAddColumn, sdbAddIndex, sdbAddTable, sdbChangeColumn, sdbClose, sdbCreateRec, sdbDelete,
     sdbGetColumns, sdbGetColumnSchema, sdbGetTables, sdbGetTableDimensions, NULL, sdbLookupField, sdbOpen, sdbQuery,
     sdbReadField, sdbFindGrid, sdbReadRecByKey, sdbRemoveColumn, sdbRemoveIndex, sdbRemoveRec, sdbRemoveTable,
-    sdbRenameTable, sdbRenameColumn, sdbSave, sdbUpdateField, sdbUpdateRec,
+    sdbRenameTable, sdbRenameColumn, sdbSave, sdbUpdateField, sdbUpdateRec, sdbConfigure, sdbOpenCursor, sdbNextRec,
+    sdbCloseCursor, sdbReadRecs, NULL,
 };
 
 /************************************* Code ***********************************/
@@ -134,12 +208,17 @@ static Sdb *sdbCreate(cchar *path, int flags)
     sdb->edi.validations = mprCreateHash(0, 0);
     sdb->edi.mutex = mprCreateLock();
     sdb->schemas = mprCreateHash(0, MPR_HASH_STABLE);
+    sdb->cursors = mprCreateList(0, MPR_LIST_STABLE);
+    sdb->writer.statements = mprCreateHash(ME_MAX_SQLITE_STATEMENTS, MPR_HASH_STABLE);
+    sdb->maxReaders = ME_MAX_SQLITE_READERS;
     return sdb;
 }
 
 
 static void manageSdb(Sdb *sdb, int flags)
 {
+    int     i;
+
     if (flags & MPR_MANAGE_MARK) {
         mprMark(sdb->edi.path);
         mprMark(sdb->edi.schemaCache);
@@ -147,23 +226,64 @@ static void manageSdb(Sdb *sdb, int flags)
         mprMark(sdb->edi.mutex);
         mprMark(sdb->edi.validations);
         mprMark(sdb->schemas);
+        mprMark(sdb->cursors);
+        mprMark(sdb->synchronous);
+        mprMark(sdb->writer.statements);
+        for (i = 0; i < ME_MAX_SQLITE_READERS; i++) {
+            mprMark(sdb->readers[i].statements);
+        }
 
     } else if (flags & MPR_MANAGE_FREE) {
-        sdbClose((Edi*) sdb);
+        /*
+            Other managed objects, including the cursors, may be freed in the same sweep so only close the SQLite handles
+         */
+        closeConns(sdb);
     }
 }
 
 
 static void sdbClose(Edi *edi)
 {
-    Sdb     *sdb;
+    Sdb         *sdb;
+    SdbCursor   *cp;
 
     assert(edi);
 
     sdb = (Sdb*) edi;
-    if (sdb->db) {
-        sqlite3_close(sdb->db);
-        sdb->db = 0;
+    /*
+        Release cursors that were not closed. releaseCursor removes the cursor from the list.
+     */
+    while ((cp = mprGetFirstItem(sdb->cursors)) != 0) {
+        releaseCursor(cp);
+    }
+    closeConns(sdb);
+}
+
+
+static void closeConns(Sdb *sdb)
+{
+    int     i;
+
+    for (i = 0; i < ME_MAX_SQLITE_READERS; i++) {
+        closeConn(&sdb->readers[i]);
+    }
+    closeConn(&sdb->writer);
+}
+
+
+static void closeConn(SdbConn *conn)
+{
+    sqlite3_stmt    *stmt;
+
+    if (conn->db) {
+        /*
+            Finalize cached statements directly as the statement cache may already be freed if called by the collector
+         */
+        while ((stmt = sqlite3_next_stmt(conn->db, 0)) != 0) {
+            sqlite3_finalize(stmt);
+        }
+        sqlite3_close(conn->db);
+        conn->db = 0;
     }
 }
 
@@ -251,12 +371,17 @@ static Edi *sdbOpen(cchar *path, int flags)
         return 0;
     }
     if (mprPathExists(path, R_OK) || (flags & EDI_CREATE)) {
-        if (sqlite3_open(path, &sdb->db) != SQLITE_OK) {
+        if (sqlite3_open(path, &sdb->writer.db) != SQLITE_OK) {
             mprLog("error esp sdb", 0, "Cannot open database %s", path);
             return 0;
         }
         sqlite3_soft_heap_limit(ME_MAX_SQLITE_MEM);
-        sqlite3_busy_timeout(sdb->db, ME_MAX_SQLITE_DURATION);
+        sqlite3_busy_timeout(sdb->writer.db, ME_MAX_SQLITE_DURATION);
+        /*
+            The journal mode is persistent in the database file. Use the read connections if it is already in WAL mode.
+            WAL mode is otherwise only enabled if configured via sdbConfigure.
+         */
+        setJournalMode(sdb, NULL);
     } else {
         return 0;
     }
@@ -264,6 +389,94 @@ static Edi *sdbOpen(cchar *path, int flags)
 }
 
 
+/*
+    Set the database journal mode. If mode is null, get the current mode. Read connections are only used in WAL mode.
+ */
+static void setJournalMode(Sdb *sdb, cchar *mode)
+{
+    EdiGrid     *grid;
+
+    if (mode) {
+        grid = query((Edi*) sdb, sfmt("PRAGMA journal_mode = %s;", mode), NULL);
+    } else {
+        grid = query((Edi*) sdb, "PRAGMA journal_mode;", NULL);
+    }
+    sdb->wal = grid && grid->nrecords > 0 && grid->records[0]->nfields > 0 &&
+        scaselessmatch(grid->records[0]->fields[0].value, "wal");
+}
+
+
+/*
+    Apply the configured pragmas to a connection
+ */
+static void applyPragmas(Sdb *sdb, sqlite3 *db)
+{
+    if (sdb->synchronous) {
+        sqlite3_exec(db, sfmt("PRAGMA synchronous = %s;", sdb->synchronous), NULL, NULL, NULL);
+    }
+    if (sdb->cacheSize > 0) {
+        /* Negative cache sizes are in KiB */
+        sqlite3_exec(db, sfmt("PRAGMA cache_size = -%lld;", sdb->cacheSize / 1024), NULL, NULL, NULL);
+    }
+    if (sdb->mmapSize > 0) {
+        sqlite3_exec(db, sfmt("PRAGMA mmap_size = %lld;", sdb->mmapSize), NULL, NULL, NULL);
+    }
+}
+
+
+/*
+    Configure the database from the "esp.sqlite" configuration. Options:
+
+        readers: Number of read-only connections. Set to zero to use only the writer connection.
+        wal: Use WAL journal mode. This changes the database file and creates -wal and -shm files beside it.
+            Defaults to false, unless the database is already in WAL mode.
+        synchronous: Synchronous pragma. Set to "off", "normal", "full" or "extra".
+        cacheSize: Page cache size per connection. Suffixes such as "MB" may be used.
+        mmapSize: Memory map size per connection. Suffixes such as "MB" may be used.
+ */
+static int sdbConfigure(Edi *edi, MprJson *options)
+{
+    Sdb     *sdb;
+    cchar   *value;
+    int     i;
+
+    sdb = (Sdb*) edi;
+    if ((value = mprGetJson(options, "readers")) != 0) {
+        sdb->maxReaders = max(0, min((int) stoi(value), ME_MAX_SQLITE_READERS));
+    }
+    if ((value = mprGetJson(options, "wal")) != 0) {
+        if (smatch(value, "true")) {
+            setJournalMode(sdb, "WAL");
+        } else if (sdb->wal) {
+            setJournalMode(sdb, "DELETE");
+        }
+    }
+    if ((value = mprGetJson(options, "synchronous")) != 0) {
+        if (!scaselessmatch(value, "off") && !scaselessmatch(value, "normal") && !scaselessmatch(value, "full") &&
+                !scaselessmatch(value, "extra")) {
+            mprLog("error esp sdb", 0, "Bad synchronous value %s", value);
+            return MPR_ERR_BAD_ARGS;
+        }
+        sdb->synchronous = sclone(value);
+    }
+    if ((value = mprGetJson(options, "cacheSize")) != 0) {
+        sdb->cacheSize = (int64) httpGetNumber(value);
+    }
+    if ((value = mprGetJson(options, "mmapSize")) != 0) {
+        sdb->mmapSize = (int64) httpGetNumber(value);
+    }
+    if (sdb->writer.db) {
+        applyPragmas(sdb, sdb->writer.db);
+    }
+    for (i = 0; i < ME_MAX_SQLITE_READERS; i++) {
+        if (sdb->readers[i].db && !sdb->readers[i].inUse) {
+            applyPragmas(sdb, sdb->readers[i].db);
+        }
+    }
+    return 0;
+}
+
+
 static int sdbAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type, int flags)
 {
     assert(edi);
@@ -282,6 +495,7 @@ static int sdbAddColumn(Edi *edi, cchar *tableName, cchar *columnName, int type,
     /*
         The field types are used for the SQLite column affinity settings
      */
+    clearStatements(edi);
     if (query(edi, sfmt("ALTER TABLE %s ADD %s %s", tableName, columnName, mapToSqlType(type)), NULL) == 0) {
         return MPR_ERR_CANT_CREATE;
     }
@@ -299,6 +513,7 @@ static int sdbAddIndex(Edi *edi, cchar *tableName, cchar *columnName, cchar *ind
     if (!validName(tableName) || !validName(columnName) || !validName(indexName)) {
         return MPR_ERR_BAD_ARGS;
     }
+    clearStatements(edi);
     return query(edi, sfmt("CREATE INDEX %s ON %s (%s);", indexName, tableName, columnName), NULL) != 0;
 }
 
@@ -311,6 +526,7 @@ static int sdbAddTable(Edi *edi, cchar *tableName)
     if (!validName(tableName)) {
         return MPR_ERR_BAD_ARGS;
     }
+    clearStatements(edi);
     if (query(edi, sfmt("DROP TABLE IF EXISTS %s;", tableName), NULL) == 0) {
         return MPR_ERR_CANT_DELETE;
     }
@@ -512,6 +728,64 @@ static EdiRec *sdbReadRecByKey(Edi *edi, cchar *tableName, cchar *key)
 }
 
 
+/*
+    Read records by key using one "IN" query per batch of keys
+ */
+static EdiGrid *sdbReadRecs(Edi *edi, cchar *tableName, int argc, cchar **keys)
+{
+    EdiGrid     *grid, *batch;
+    EdiRec      *rec, *schema;
+    MprList     *recs;
+    MprBuf      *buf;
+    cchar       *keyName;
+    int         count, i, keyField, r;
+
+    if (!validName(tableName)) {
+        return 0;
+    }
+    if ((schema = getSchema(edi, tableName)) == 0) {
+        return 0;
+    }
+    keyField = -1;
+    keyName = "id";
+    for (r = 0; r < schema->nfields; r++) {
+        if (schema->fields[r].flags & EDI_KEY) {
+            keyField = r;
+            keyName = schema->fields[r].name;
+            break;
+        }
+    }
+    recs = mprCreateList(argc, 0);
+    for (i = 0; i < argc; i += count) {
+        count = min(argc - i, ME_MAX_SQLITE_KEYS);
+        buf = mprCreateBuf(0, 0);
+        mprPutToBuf(buf, "SELECT * FROM \"%s\" WHERE \"%s\" IN (?", tableName, keyName);
+        for (r = 1; r < count; r++) {
+            mprPutStringToBuf(buf, ",?");
+        }
+        mprPutStringToBuf(buf, ");");
+        if ((batch = queryArgv(edi, mprBufToString(buf), count, &keys[i], NULL)) == 0) {
+            return 0;
+        }
+        for (r = 0; r < batch->nrecords; r++) {
+            rec = batch->records[r];
+            if (keyField >= 0 && keyField < rec->nfields) {
+                rec->fields[keyField].flags |= EDI_KEY;
+                rec->id = rec->fields[keyField].value;
+            }
+            mprAddItem(recs, rec);
+        }
+    }
+    if ((grid = ediCreateBareGrid(edi, tableName, mprGetListLength(recs))) == 0) {
+        return 0;
+    }
+    for (r = 0; r < grid->nrecords; r++) {
+        grid->records[r] = mprGetItem(recs, r);
+    }
+    return grid;
+}
+
+
 static EdiGrid *setTableName(EdiGrid *grid, cchar *tableName)
 {
     if (grid && !grid->tableName) {
@@ -556,17 +830,23 @@ static cchar *parseSdbQuery(cchar *query, int *offsetp, int *limitp)
 }
 
 
-static EdiGrid *sdbFindGrid(Edi *edi, cchar *tableName, cchar *select)
+/*
+    Build the SQL command for a query. The query values are returned via argc and argv for binding.
+ */
+static char *buildFindQuery(Edi *edi, cchar *tableName, cchar *select, int *argc, cchar ***argv, int *offsetp,
+    int *limitp)
 {
-    EdiGrid     *grid;
     EdiRec      *schema;
     MprBuf      *buf;
-    cchar       *columnName, *expressions, *operation, *sql, **values;
+    cchar       *columnName, *expressions, *operation, **values;
     char        *tok, *value;
     int         i, limit, offset;
 
     assert(tableName && *tableName);
     columnName = operation = value = 0;
+    offset = limit = 0;
+    *argc = 0;
+    *argv = 0;
 
     if (select) {
         if ((expressions = parseSdbQuery(select, &offset, &limit)) == 0) {
@@ -591,6 +871,9 @@ static EdiGrid *sdbFindGrid(Edi *edi, cchar *tableName, cchar *select)
     if (offset < 0) {
         offset = 0;
     }
+    *offsetp = offset;
+    *limitp = limit;
+
     if (columnName) {
         if (smatch(columnName, "*")) {
             schema = getSchema(edi, tableName);
@@ -611,20 +894,38 @@ static EdiGrid *sdbFindGrid(Edi *edi, cchar *tableName, cchar *select)
                 values[i] = value;
             }
             mprPutToBuf(buf, " LIMIT %d, %d;", offset, limit);
-            sql = mprBufToString(buf);
-            grid = queryArgv(edi, sql, schema->nfields, values, NULL);
+            *argc = schema->nfields;
+            *argv = values;
+            return mprBufToString(buf);
 
         } else {
             if (!validName(columnName)) {
                 return 0;
             }
-            sql = sfmt("SELECT * FROM %s WHERE %s %s ? LIMIT %d, %d;", tableName, columnName, operation, offset, limit);
-            grid = query(edi, sql, value, NULL);
+            if ((values = mprAlloc(sizeof(cchar*) * 2)) == 0) {
+                return 0;
+            }
+            values[0] = value;
+            values[1] = 0;
+            *argc = 1;
+            *argv = values;
+            return sfmt("SELECT * FROM %s WHERE %s %s ? LIMIT %d, %d;", tableName, columnName, operation, offset, limit);
         }
-    } else {
-        sql = sfmt("SELECT * FROM %s LIMIT %d, %d;", tableName, offset, limit);
-        grid = query(edi, sql, NULL);
     }
+    return sfmt("SELECT * FROM %s LIMIT %d, %d;", tableName, offset, limit);
+}
+
+
+static EdiGrid *sdbFindGrid(Edi *edi, cchar *tableName, cchar *select)
+{
+    EdiGrid     *grid;
+    cchar       *sql, **values;
+    int         argc, limit, offset;
+
+    if ((sql = buildFindQuery(edi, tableName, select, &argc, &values, &offset, &limit)) == 0) {
+        return 0;
+    }
+    grid = queryArgv(edi, sql, argc, values, NULL);
     if (grid) {
         if (offset > 0 || grid->nrecords == limit) {
             sdbGetTableDimensions(edi, tableName, &grid->count, NULL);
@@ -636,6 +937,137 @@ static EdiGrid *sdbFindGrid(Edi *edi, cchar *tableName, cchar *select)
 }
 
 
+/*
+    Open a cursor for a query. The statement is stepped by sdbNextRec so rows are read from SQLite one at a time.
+    The cursor holds a connection until closed, or until the database is closed.
+ */
+static int sdbOpenCursor(EdiCursor *cursor, cchar *select)
+{
+    Sdb             *sdb;
+    SdbConn         *conn;
+    SdbCursor       *cp;
+    SdbStatement    *sp;
+    sqlite3_stmt    *stmt;
+    cchar           *sql, **values, *tail;
+    int             argc, index, limit, offset;
+
+    sdb = (Sdb*) cursor->edi;
+    sdb->edi.errMsg = 0;
+    if (sdb->writer.db == 0) {
+        sdbError(cursor->edi, "Database '%s' is closed", sdb->edi.path);
+        return MPR_ERR_BAD_STATE;
+    }
+    if ((sql = buildFindQuery(cursor->edi, cursor->tableName, select, &argc, &values, &offset, &limit)) == 0) {
+        return MPR_ERR_BAD_ARGS;
+    }
+    mprLog("info esp sdb", 4, "SQL: %s", sql);
+    conn = acquireConn(sdb, sql);
+    if ((sp = getStatement(sdb, conn, sql)) != 0) {
+        stmt = sp->stmt;
+    } else {
+        if (sqlite3_prepare_v2(conn->db, sql, -1, &stmt, &tail) != SQLITE_OK || stmt == 0) {
+            sdbDebug(cursor->edi, 2, "SDB: cannot prepare command: %s, error: %s", sql, sqlite3_errmsg(conn->db));
+            releaseConn(sdb, conn);
+            return MPR_ERR_BAD_ARGS;
+        }
+        sp = addStatement(sdb, conn, sql, stmt);
+    }
+    for (index = 0; index < argc; index++) {
+        if (sqlite3_bind_text(stmt, index + 1, values[index], -1, SQLITE_TRANSIENT) != SQLITE_OK) {
+            sdbError(cursor->edi, "SDB: cannot bind to arg: %d, %s, error: %s", index + 1, values[index],
+                sqlite3_errmsg(conn->db));
+            releaseStatement(sdb, conn, sp, stmt);
+            releaseConn(sdb, conn);
+            return MPR_ERR_BAD_ARGS;
+        }
+    }
+    if ((cp = mprAllocObj(SdbCursor, manageSdbCursor)) == 0) {
+        releaseStatement(sdb, conn, sp, stmt);
+        releaseConn(sdb, conn);
+        return MPR_ERR_MEMORY;
+    }
+    cp->sdb = sdb;
+    cp->conn = conn;
+    cp->sp = sp;
+    cp->stmt = stmt;
+    cp->ncol = sqlite3_column_count(stmt);
+    cp->offset = offset;
+    cp->limit = limit;
+    mprAddItem(sdb->cursors, cp);
+    cursor->data = cp;
+    return 0;
+}
+
+
+static EdiRec *sdbNextRec(EdiCursor *cursor)
+{
+    SdbCursor   *cp;
+    EdiRec      *rec;
+    int         rc;
+
+    cp = cursor->data;
+    if (!cp->stmt) {
+        return 0;
+    }
+    if ((rc = sqlite3_step(cp->stmt)) != SQLITE_ROW) {
+        if (rc != SQLITE_DONE) {
+            sdbDebug(cursor->edi, 2, "SDB: cannot step cursor, error: %s", sqlite3_errmsg(cp->conn->db));
+        }
+        /* Release the statement and connection as soon as the results are exhausted */
+        sdbCloseCursor(cursor);
+        /*
+            Count the available records in the same way as sdbFindGrid
+         */
+        if (cp->offset > 0 || cp->nrecords == cp->limit) {
+            sdbGetTableDimensions(cursor->edi, cursor->tableName, &cursor->count, NULL);
+        } else {
+            cursor->count = cp->nrecords;
+        }
+        return 0;
+    }
+    if ((rec = createRecFromStmt(cursor->edi, cp->stmt, cp->ncol, &cp->defaultTableName)) == 0) {
+        return 0;
+    }
+    cp->nrecords++;
+    return rec;
+}
+
+
+static void sdbCloseCursor(EdiCursor *cursor)
+{
+    if (cursor->data) {
+        releaseCursor(cursor->data);
+    }
+}
+
+
+/*
+    Release the statement and connection held by a cursor and remove it from the list of open cursors
+ */
+static void releaseCursor(SdbCursor *cp)
+{
+    mprRemoveItem(cp->sdb->cursors, cp);
+    if (!cp->stmt) {
+        return;
+    }
+    releaseStatement(cp->sdb, cp->conn, cp->sp, cp->stmt);
+    releaseConn(cp->sdb, cp->conn);
+    cp->stmt = 0;
+    cp->sp = 0;
+    cp->conn = 0;
+}
+
+
+static void manageSdbCursor(SdbCursor *cp, int flags)
+{
+    if (flags & MPR_MANAGE_MARK) {
+        mprMark(cp->sdb);
+        mprMark(cp->sp);
+        mprMark(cp->defaultTableName);
+    }
+}
+
+
 static int sdbRemoveColumn(Edi *edi, cchar *tableName, cchar *columnName)
 {
     mprLog("error esp sdb", 0, "SDB does not support removing columns");
@@ -648,6 +1080,7 @@ static int sdbRemoveIndex(Edi *edi, cchar *tableName, cchar *indexName)
     if (!validName(tableName) || !validName(indexName)) {
         return 0;
     }
+    clearStatements(edi);
     return query(edi, sfmt("DROP INDEX %s;", indexName), NULL) != 0;
 }
 
@@ -670,6 +1103,7 @@ static int sdbRemoveTable(Edi *edi, cchar *tableName)
     if (!validName(tableName)) {
         return 0;
     }
+    clearStatements(edi);
     return query(edi, sfmt("DROP TABLE IF EXISTS %s;", tableName), NULL) != 0;
 }
 
@@ -681,6 +1115,7 @@ static int sdbRenameTable(Edi *edi, cchar *tableName, cchar *newTableName)
     }
     removeSchema(edi, tableName);
     removeSchema(edi, newTableName);
+    clearStatements(edi);
     return query(edi, sfmt("ALTER TABLE %s RENAME TO %s;", tableName, newTableName), NULL) != 0;
 }
 
@@ -740,7 +1175,7 @@ static int sdbUpdateField(Edi *edi, cchar *tableName, cchar *key, cchar *fieldNa
     }
     sdbGetColumnSchema(edi, tableName, fieldName, &type, 0, 0);
     value = mapSdbValue(value, type);
-    return query(edi, sfmt("UPDATE %s SET %s TO ? WHERE 'id' = ?;", tableName, fieldName), value, key, NULL) != 0;
+    return query(edi, sfmt("UPDATE %s SET %s = ? WHERE id = ?;", tableName, fieldName), value, key, NULL) != 0;
 }
 
 
@@ -841,15 +1276,15 @@ static EdiGrid *queryArgv(Edi *edi, cchar *cmd, int argc, cchar **argv, ...)
 static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list vargs)
 {
     Sdb             *sdb;
+    SdbConn         *conn;
+    SdbStatement    *sp;
     sqlite3         *db;
     sqlite3_stmt    *stmt;
     EdiGrid         *grid;
-    EdiRec          *rec, *schema;
+    EdiRec          *rec;
     MprList         *result;
-    char            *tableName;
-    cchar           *tail, *colName, *value, *defaultTableName, *arg;
-    ssize           len;
-    int             r, nrows, i, ncol, rc, retries, index, type;
+    cchar           *tail, *defaultTableName, *arg, *cp;
+    int             r, nrows, ncol, rc, retries, index;
 
     assert(edi);
     assert(cmd && *cmd);
@@ -858,34 +1293,48 @@ static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list var
     retries = 0;
     sdb->edi.errMsg = 0;
 
-    if ((db = sdb->db) == 0) {
+    if (sdb->writer.db == 0) {
         sdbError(edi, "Database '%s' is closed", sdb->edi.path);
         return 0;
     }
     if ((result = mprCreateList(0, MPR_LIST_STABLE)) == 0) {
         return 0;
     }
+    conn = acquireConn(sdb, cmd);
+    db = conn->db;
     defaultTableName = 0;
+    sp = 0;
+    stmt = 0;
     rc = SQLITE_OK;
     nrows = 0;
 
     while (cmd && *cmd && (rc == SQLITE_OK || (rc == SQLITE_SCHEMA && ++retries < 2))) {
         stmt = 0;
         mprLog("info esp sdb", 4, "SQL: %s", cmd);
-        rc = sqlite3_prepare_v2(db, cmd, -1, &stmt, &tail);
-        if (rc != SQLITE_OK) {
-            sdbDebug(edi, 2, "SDB: cannot prepare command: %s, error: %s", cmd, sqlite3_errmsg(db));
-            continue;
-        }
-        if (stmt == 0) {
-            /* Comment or white space */
-            cmd = tail;
-            continue;
+        if ((sp = getStatement(sdb, conn, cmd)) != 0) {
+            stmt = sp->stmt;
+            tail = &cmd[slen(cmd)];
+        } else {
+            rc = sqlite3_prepare_v2(db, cmd, -1, &stmt, &tail);
+            if (rc != SQLITE_OK) {
+                sdbDebug(edi, 2, "SDB: cannot prepare command: %s, error: %s", cmd, sqlite3_errmsg(db));
+                continue;
+            }
+            if (stmt == 0) {
+                /* Comment or white space */
+                cmd = tail;
+                continue;
+            }
+            /* Only cache commands with a single statement */
+            for (cp = tail; isspace((uchar) *cp); cp++) {}
+            sp = (*cp == '\0') ? addStatement(sdb, conn, cmd, stmt) : 0;
         }
         if (argc == 0) {
             for (index = 0; (arg = va_arg(vargs, cchar*)) != 0; index++) {
                 if (sqlite3_bind_text(stmt, index + 1, arg, -1, 0) != SQLITE_OK) {
                     sdbError(edi, "SDB: cannot bind to arg: %d, %s, error: %s", index + 1, arg, sqlite3_errmsg(db));
+                    releaseStatement(sdb, conn, sp, stmt);
+                    releaseConn(sdb, conn);
                     return 0;
                 }
             }
@@ -893,6 +1342,8 @@ static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list var
             for (index = 0; index < argc; index++) {
                 if (sqlite3_bind_text(stmt, index + 1, argv[index], -1, 0) != SQLITE_OK) {
                     sdbError(edi, "SDB: cannot bind to arg: %d, %s, error: %s", index + 1, argv[index], sqlite3_errmsg(db));
+                    releaseStatement(sdb, conn, sp, stmt);
+                    releaseConn(sdb, conn);
                     return 0;
                 }
             }
@@ -900,36 +1351,14 @@ static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list var
         ncol = sqlite3_column_count(stmt);
         for (nrows = 0; ; nrows++) {
             if (sqlite3_step(stmt) == SQLITE_ROW) {
-                tableName = (char*) sqlite3_column_table_name(stmt, 0);
-                if ((rec = createBareRec(edi, tableName, ncol)) == 0) {
-                    sqlite3_finalize(stmt);
+                if ((rec = createRecFromStmt(edi, stmt, ncol, &defaultTableName)) == 0) {
+                    releaseStatement(sdb, conn, sp, stmt);
+                    releaseConn(sdb, conn);
                     return 0;
                 }
-                if (defaultTableName == 0) {
-                    defaultTableName = rec->tableName;
-                }
                 mprAddItem(result, rec);
-                for (i = 0; i < ncol; i++) {
-                    colName = sqlite3_column_name(stmt, i);
-                    value = (cchar*) sqlite3_column_text(stmt, i);
-                    if (tableName && strcmp(tableName, defaultTableName) != 0) {
-                        len = strlen(tableName) + 1;
-                        tableName = sjoin("_", tableName, colName, NULL);
-                        tableName[len] = toupper((uchar) tableName[len]);
-                    }
-                    if (tableName && ((schema = getSchema(edi, tableName)) != 0)) {
-                        rec->fields[i] = makeRecField(value, colName, schema->fields[i].type);
-                    } else {
-                        type = sqlite3_column_type(stmt, i);
-                        rec->fields[i] = makeRecField(value, colName, mapSqliteTypeToEdiType(type));
-                    }
-                    if (smatch(colName, "id")) {
-                        rec->fields[i].flags |= EDI_KEY;
-                        rec->id = rec->fields[i].value;
-                    }
-                }
             } else {
-                rc = sqlite3_finalize(stmt);
+                rc = releaseStatement(sdb, conn, sp, stmt);
                 stmt = 0;
                 if (rc != SQLITE_SCHEMA) {
                     retries = 0;
@@ -940,7 +1369,7 @@ static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list var
         }
     }
     if (stmt) {
-        rc = sqlite3_finalize(stmt);
+        rc = releaseStatement(sdb, conn, sp, stmt);
     }
     if (rc != SQLITE_OK) {
         if (rc == sqlite3_errcode(db)) {
@@ -948,8 +1377,10 @@ static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list var
         } else {
             sdbDebug(edi, 2, "SDB: unspecified SQL error for: %s", cmd);
         }
+        releaseConn(sdb, conn);
         return 0;
     }
+    releaseConn(sdb, conn);
     if ((grid = ediCreateBareGrid(edi, defaultTableName, nrows)) == 0) {
         return 0;
     }
@@ -960,6 +1391,285 @@ static EdiGrid *queryv(Edi *edi, cchar *cmd, int argc, cchar **argv, va_list var
 }
 
 
+/*
+    Test if a command is a single SELECT statement that can use a read-only connection
+ */
+static bool isReadQuery(cchar *cmd)
+{
+    cchar   *cp;
+
+    for (; isspace((uchar) *cmd); cmd++) {}
+    if (sncaselesscmp(cmd, "SELECT", 6) != 0) {
+        return 0;
+    }
+    if ((cp = schr(cmd, ';')) != 0) {
+        for (cp++; isspace((uchar) *cp); cp++) {}
+        return *cp == '\0';
+    }
+    return 1;
+}
+
+
+/*
+    Get a connection for a command. SELECT queries use an idle read connection if one is available.
+    Read connections are opened on demand up to the configured limit. Otherwise the writer connection is used.
+    While a transaction is open on the writer, all queries use the writer so they see the uncommitted changes.
+ */
+static SdbConn *acquireConn(Sdb *sdb, cchar *cmd)
+{
+    SdbConn     *conn, *reader;
+    int         i, flags;
+
+    if (!sdb->wal || sdb->maxReaders <= 0 || !isReadQuery(cmd) || !sqlite3_get_autocommit(sdb->writer.db)) {
+        return &sdb->writer;
+    }
+    reader = 0;
+    mprLock(sdb->edi.mutex);
+    for (i = 0; i < sdb->maxReaders; i++) {
+        conn = &sdb->readers[i];
+        if (!conn->inUse) {
+            if (conn->db) {
+                conn->inUse = 1;
+                mprUnlock(sdb->edi.mutex);
+                return conn;
+            }
+            if (!reader) {
+                reader = conn;
+            }
+        }
+    }
+    if (reader) {
+        /* Reserve the slot while opening */
+        reader->inUse = 1;
+    }
+    mprUnlock(sdb->edi.mutex);
+
+    if (reader == 0) {
+        return &sdb->writer;
+    }
+    flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(sdb->edi.path, &reader->db, flags, NULL) != SQLITE_OK) {
+        mprLog("error esp sdb", 0, "Cannot open read connection for %s", sdb->edi.path);
+        closeConn(reader);
+        releaseConn(sdb, reader);
+        return &sdb->writer;
+    }
+    sqlite3_busy_timeout(reader->db, ME_MAX_SQLITE_DURATION);
+    applyPragmas(sdb, reader->db);
+    reader->statements = mprCreateHash(ME_MAX_SQLITE_STATEMENTS, MPR_HASH_STABLE);
+    return reader;
+}
+
+
+static void releaseConn(Sdb *sdb, SdbConn *conn)
+{
+    if (conn != &sdb->writer) {
+        mprLock(sdb->edi.mutex);
+        if (conn->stale) {
+            /* The schema changed while this connection was busy */
+            clearConnStatements(conn);
+            conn->stale = 0;
+        }
+        conn->inUse = 0;
+        mprUnlock(sdb->edi.mutex);
+    }
+}
+
+
+/*
+    Get a cached prepared statement for a command. The statement is marked as in-use until released.
+ */
+static SdbStatement *getStatement(Sdb *sdb, SdbConn *conn, cchar *cmd)
+{
+    SdbStatement    *sp;
+
+    if (ME_MAX_SQLITE_STATEMENTS <= 0) {
+        return 0;
+    }
+    mprLock(sdb->edi.mutex);
+    if ((sp = mprLookupKey(conn->statements, cmd)) != 0) {
+        if (sp->inUse) {
+            /* Nested or concurrent use of the same command */
+            sp = 0;
+        } else {
+            sp->inUse = 1;
+            sp->used = ++sdb->statementSeq;
+        }
+    }
+    mprUnlock(sdb->edi.mutex);
+    return sp;
+}
+
+
+/*
+    Add a newly prepared statement to the cache. Only queries and data manipulation statements are cached.
+    The least recently used statement is finalized if the cache is full.
+ */
+static SdbStatement *addStatement(Sdb *sdb, SdbConn *conn, cchar *cmd, sqlite3_stmt *stmt)
+{
+    SdbStatement    *sp, *oldest;
+    MprKey          *kp, *oldestKey;
+
+    if (ME_MAX_SQLITE_STATEMENTS <= 0) {
+        return 0;
+    }
+    if (!sqlite3_stmt_readonly(stmt) && !sstarts(cmd, "INSERT") && !sstarts(cmd, "UPDATE") && !sstarts(cmd, "DELETE")) {
+        return 0;
+    }
+    mprLock(sdb->edi.mutex);
+    if (mprGetHashLength(conn->statements) >= ME_MAX_SQLITE_STATEMENTS) {
+        oldest = 0;
+        oldestKey = 0;
+        for (ITERATE_KEYS(conn->statements, kp)) {
+            sp = (SdbStatement*) kp->data;
+            if (!sp->inUse && (oldest == 0 || sp->used < oldest->used)) {
+                oldest = sp;
+                oldestKey = kp;
+            }
+        }
+        if (oldest == 0) {
+            mprUnlock(sdb->edi.mutex);
+            return 0;
+        }
+        sqlite3_finalize(oldest->stmt);
+        mprRemoveKey(conn->statements, oldestKey->key);
+    }
+    if ((sp = mprAllocObj(SdbStatement, 0)) != 0) {
+        sp->stmt = stmt;
+        sp->inUse = 1;
+        sp->used = ++sdb->statementSeq;
+        mprAddKey(conn->statements, cmd, sp);
+    }
+    mprUnlock(sdb->edi.mutex);
+    return sp;
+}
+
+
+/*
+    Release a statement after use. Cached statements are reset for reuse, others are finalized.
+    Returns the SQLite result of the last statement step.
+ */
+static int releaseStatement(Sdb *sdb, SdbConn *conn, SdbStatement *sp, sqlite3_stmt *stmt)
+{
+    MprKey  *kp;
+    int     rc;
+
+    if (sp == 0) {
+        return sqlite3_finalize(stmt);
+    }
+    rc = sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+
+    mprLock(sdb->edi.mutex);
+    sp->inUse = 0;
+    if (rc == SQLITE_SCHEMA && !sp->stale) {
+        for (ITERATE_KEYS(conn->statements, kp)) {
+            if (kp->data == sp) {
+                mprRemoveKey(conn->statements, kp->key);
+                break;
+            }
+        }
+        sp->stale = 1;
+    }
+    if (sp->stale) {
+        sqlite3_finalize(stmt);
+    }
+    mprUnlock(sdb->edi.mutex);
+    return rc;
+}
+
+
+/*
+    Discard the cached statements of a connection
+ */
+static void clearConnStatements(SdbConn *conn)
+{
+    SdbStatement    *sp;
+    MprKey          *kp;
+
+    if (conn->statements == 0) {
+        return;
+    }
+    for (ITERATE_KEYS(conn->statements, kp)) {
+        sp = (SdbStatement*) kp->data;
+        if (sp->inUse) {
+            sp->stale = 1;
+        } else {
+            sqlite3_finalize(sp->stmt);
+        }
+    }
+    conn->statements = mprCreateHash(ME_MAX_SQLITE_STATEMENTS, MPR_HASH_STABLE);
+}
+
+
+/*
+    Discard all cached statements. Called when the database schema is modified.
+    Read connections are opened without a mutex and may be running a query on another thread. The statements of busy
+    readers are discarded when the reader is released.
+ */
+static void clearStatements(Edi *edi)
+{
+    Sdb     *sdb;
+    SdbConn *reader;
+    int     i;
+
+    sdb = (Sdb*) edi;
+    mprLock(sdb->edi.mutex);
+    clearConnStatements(&sdb->writer);
+    for (i = 0; i < ME_MAX_SQLITE_READERS; i++) {
+        reader = &sdb->readers[i];
+        if (reader->inUse) {
+            reader->stale = 1;
+        } else {
+            clearConnStatements(reader);
+        }
+    }
+    mprUnlock(sdb->edi.mutex);
+}
+
+
+/*
+    Create a record from the current row of a statement. The defaultTableName is set to the table of the first row
+    and columns from other (joined) tables are named "table_Column".
+ */
+static EdiRec *createRecFromStmt(Edi *edi, sqlite3_stmt *stmt, int ncol, cchar **defaultTableName)
+{
+    EdiRec      *rec, *schema;
+    char        *tableName;
+    cchar       *colName, *value;
+    ssize       len;
+    int         i, type;
+
+    tableName = (char*) sqlite3_column_table_name(stmt, 0);
+    if ((rec = createBareRec(edi, tableName, ncol)) == 0) {
+        return 0;
+    }
+    if (*defaultTableName == 0) {
+        *defaultTableName = rec->tableName;
+    }
+    for (i = 0; i < ncol; i++) {
+        colName = sqlite3_column_name(stmt, i);
+        value = (cchar*) sqlite3_column_text(stmt, i);
+        if (tableName && strcmp(tableName, *defaultTableName) != 0) {
+            len = strlen(tableName) + 1;
+            tableName = sjoin("_", tableName, colName, NULL);
+            tableName[len] = toupper((uchar) tableName[len]);
+        }
+        if (tableName && ((schema = getSchema(edi, tableName)) != 0)) {
+            rec->fields[i] = makeRecField(value, colName, schema->fields[i].type);
+        } else {
+            type = sqlite3_column_type(stmt, i);
+            rec->fields[i] = makeRecField(value, colName, mapSqliteTypeToEdiType(type));
+        }
+        if (smatch(colName, "id")) {
+            rec->fields[i].flags |= EDI_KEY;
+            rec->id = rec->fields[i].value;
+        }
+    }
+    return rec;
+}
+
+
 static EdiRec *createBareRec(Edi *edi, cchar *tableName, int nfields)
 {
     EdiRec  *rec;
@@ -0,0 +1,39 @@
+/*
+    gzip.tst - Test the gzip variant of server-side cached responses
+ */
+
+if (!thas('ME_ZLIB')) {
+    tskip("zlib not enabled")
+
+} else {
+    const HTTP = tget('TM_HTTP') || "127.0.0.1:4100"
+    let http: Http = new Http
+
+    //  Clear cached data and prime the cache
+    http.get(HTTP + "/caching/clear")
+    ttrue(http.status == 200)
+    http.get(HTTP + "/caching/big")
+    ttrue(http.status == 200)
+    http.close()
+
+    //  Clients that accept gzip get the gzip variant
+    http = new Http
+    http.setHeader("Accept-Encoding", "gzip")
+    http.get(HTTP + "/caching/big")
+    ttrue(http.status == 200)
+    ttrue(http.header("Content-Encoding") == "gzip")
+    ttrue(http.header("Vary").contains("Accept-Encoding"))
+    ttrue(http.header("Content-Length") < 78000)
+    http.close()
+
+    //  Other clients get the identity body
+    http = new Http
+    http.setHeader("Accept-Encoding", "identity")
+    http.get(HTTP + "/caching/big")
+    ttrue(http.status == 200)
+    ttrue(!http.header("Content-Encoding"))
+    ttrue(http.header("Vary").contains("Accept-Encoding"))
+    ttrue(http.header("Content-Length") == 78000)
+    ttrue(http.response.contains("Line: 00499 aaaaaaaaaaaaaaaaaabbbbbbbbbbbbbbbbccccccccccccccccccddddddd<br/>"))
+    http.close()
+}
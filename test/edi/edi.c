@@ -0,0 +1,328 @@
+/*
+    edi.c - Test the MDB and SDB database providers
+
+    Each action exercises a database feature and renders the results as JSON for edi.tst to check.
+ */
+#include "esp.h"
+
+/*
+    Return the path of a test database. Any prior database and its journal files are removed.
+ */
+static cchar *getDatabasePath(cchar *name)
+{
+    cchar   *path;
+
+    path = mprJoinPaths(getRoute()->home, httpGetDir(getRoute(), "DB"), name, NULL);
+    mprMakeDir(mprGetPathDir(path), 0755, -1, -1, 1);
+    mprDeletePath(path);
+    mprDeletePath(mprReplacePathExt(path, "jnl"));
+    mprDeletePath(sjoin(path, "-wal", NULL));
+    mprDeletePath(sjoin(path, "-shm", NULL));
+    return path;
+}
+
+
+static EdiGrid *query(Edi *edi, cchar *cmd, ...)
+{
+    EdiGrid     *grid;
+    va_list     args;
+
+    va_start(args, cmd);
+    grid = ediQuery(edi, cmd, 0, NULL, args);
+    va_end(args);
+    return grid;
+}
+
+
+static int count(Edi *edi, cchar *tableName, cchar *where)
+{
+    EdiGrid     *grid;
+
+    grid = ediFindGrid(edi, tableName, where);
+    return grid ? grid->nrecords : -1;
+}
+
+
+/*
+    Create a sensor table with 100 rows. The reading of row 50 is a string that is not numeric.
+ */
+static void createSensors(Edi *edi)
+{
+    EdiRec      *rec;
+    int         i;
+
+    ediAddTable(edi, "sensor");
+    ediAddColumn(edi, "sensor", "id", EDI_TYPE_INT, EDI_AUTO_INC | EDI_INDEX | EDI_KEY);
+    ediAddColumn(edi, "sensor", "name", EDI_TYPE_STRING, EDI_INDEX);
+    ediAddColumn(edi, "sensor", "value", EDI_TYPE_FLOAT, 0);
+    ediAddColumn(edi, "sensor", "reading", EDI_TYPE_STRING, 0);
+    for (i = 1; i <= 100; i++) {
+        rec = ediCreateRec(edi, "sensor");
+        ediSetField(rec, "name", (i % 2) ? "odd" : "even");
+        ediSetField(rec, "value", sfmt("%d.5", i));
+        ediSetField(rec, "reading", (i == 50) ? "n/a" : itos(i));
+        ediUpdateRec(edi, rec);
+    }
+}
+
+
+/*
+    Typed cells. Numeric columns are compared and sorted as numbers rather than as strings.
+ */
+static void types()
+{
+    Edi         *edi;
+    EdiGrid     *grid;
+    cchar       *path;
+    int         below;
+
+    path = getDatabasePath("types.mdb");
+    edi = ediOpen(path, "mdb", EDI_CREATE);
+    createSensors(edi);
+    ediUpdateField(edi, "sensor", "100", "value", "-.5");
+
+    below = count(edi, "sensor", "value < 10");
+    grid = ediSortGrid(ediFindGrid(edi, "sensor", "name == even"), "id", -1);
+
+    render("{\"below\": %d, \"first\": \"%s\", \"last\": \"%s\", \"signed\": \"%s\"}",
+        below, ediGetFieldValue(grid->records[0], "id"),
+        ediGetFieldValue(grid->records[grid->nrecords - 1], "id"),
+        ediReadFieldValue(edi, NULL, "sensor", "100", "value", ""));
+}
+
+
+/*
+    Columnar tables: queries, aggregates and column type changes
+ */
+static void columnar()
+{
+    Edi         *edi;
+    cchar       *path;
+    double      sum, min, max, avg, odd;
+    int         before, after, reloaded, found;
+
+    path = getDatabasePath("columnar.mdb");
+    edi = ediOpen(path, "mdb", EDI_CREATE | EDI_COLUMNAR);
+    createSensors(edi);
+
+    found = count(edi, "sensor", "value >= 90");
+    ediAggregate(edi, "sensor", "value", NULL, EDI_AGG_SUM, &sum);
+    ediAggregate(edi, "sensor", "value", NULL, EDI_AGG_MIN, &min);
+    ediAggregate(edi, "sensor", "value", NULL, EDI_AGG_MAX, &max);
+    ediAggregate(edi, "sensor", "value", NULL, EDI_AGG_AVG, &avg);
+    ediAggregate(edi, "sensor", "value", "name == odd", EDI_AGG_COUNT, &odd);
+
+    //  String comparison before the change and numeric comparison after. The "n/a" reading remains a string.
+    before = count(edi, "sensor", "reading <= 9");
+    ediChangeColumn(edi, "sensor", "reading", EDI_TYPE_INT, 0);
+    after = count(edi, "sensor", "reading <= 9");
+    ediSave(edi);
+
+    //  The columnar layout is saved with the table
+    edi = ediOpen(path, "mdb", 0);
+    reloaded = count(edi, "sensor", "value >= 90");
+
+    render("{\"found\": %d, \"sum\": %g, \"min\": %g, \"max\": %g, \"avg\": %g, \"odd\": %g, "
+        "\"before\": %d, \"after\": %d, \"reloaded\": %d, \"na\": \"%s\"}",
+        found, sum, min, max, avg, odd, before, after, reloaded,
+        ediReadFieldValue(edi, NULL, "sensor", "50", "reading", ""));
+}
+
+
+/*
+    Auto-saved row changes are journaled and replayed when the database is next loaded
+ */
+static void journal()
+{
+    Edi         *edi, *copy;
+    MprFile     *file;
+    cchar       *path, *jnl;
+    bool        journaled, removed;
+    int         rows;
+
+    path = getDatabasePath("journal.mdb");
+    jnl = mprReplacePathExt(path, "jnl");
+    edi = ediOpen(path, "mdb", EDI_CREATE | EDI_AUTO_SAVE);
+    createSensors(edi);
+    ediSave(edi);
+    ediUpdateField(edi, "sensor", "1", "name", "updated");
+    ediRemoveRec(edi, "sensor", "2");
+    journaled = mprPathExists(jnl, R_OK);
+
+    //  Simulate a crash while writing a final record. The incomplete record is ignored.
+    if ((file = mprOpenFile(jnl, O_WRONLY | O_APPEND | O_BINARY, 0644)) != 0) {
+        mprWriteFileString(file, "{\"op\":\"remove\",\"tab");
+        mprCloseFile(file);
+    }
+    if ((copy = ediOpen(path, "mdb", 0)) == 0) {
+        renderError(HTTP_CODE_INTERNAL_SERVER_ERROR, "Cannot open database with an incomplete journal");
+        return;
+    }
+    rows = count(copy, "sensor", NULL);
+
+    //  A full save discards the journal
+    ediSave(edi);
+    removed = !mprPathExists(jnl, R_OK);
+
+    render("{\"journaled\": %s, \"rows\": %d, \"name\": \"%s\", \"removed\": %s}",
+        journaled ? "true" : "false", rows,
+        ediReadFieldValue(copy, NULL, "sensor", "1", "name", ""), removed ? "true" : "false");
+}
+
+
+/*
+    Binary snapshots round trip typed values and strings
+ */
+#define NOTE "line one\nit's \"quoted\"\\"
+
+static void snapshot()
+{
+    Edi         *edi;
+    EdiRec      *rec;
+    cchar       *path, *data, *partial;
+    ssize       len;
+    bool        binary;
+
+    path = getDatabasePath("snapshot.mdbx");
+    edi = ediOpen(path, "mdb", EDI_CREATE);
+    createSensors(edi);
+    ediAddColumn(edi, "sensor", "active", EDI_TYPE_BOOL, 0);
+    ediAddColumn(edi, "sensor", "when", EDI_TYPE_DATE, 0);
+    ediAddColumn(edi, "sensor", "note", EDI_TYPE_TEXT, 0);
+    rec = ediCreateRec(edi, "sensor");
+    ediSetField(rec, "value", "-0.25");
+    ediSetField(rec, "active", "true");
+    ediSetField(rec, "when", "1500000000000");
+    ediSetField(rec, "note", NOTE);
+    ediUpdateRec(edi, rec);
+    ediSave(edi);
+
+    data = mprReadPathContents(path, &len);
+    binary = data && len > 4 && memcmp(data, "\x89MDB", 4) == 0;
+
+    //  A truncated snapshot is rejected
+    partial = getDatabasePath("partial.mdbx");
+    mprWritePathContents(partial, data, len / 2, 0644);
+
+    edi = ediOpen(path, "mdb", 0);
+    rec = ediReadRec(edi, "sensor", "101");
+    render("{\"binary\": %s, \"rows\": %d, \"value\": \"%s\", \"active\": \"%s\", \"when\": \"%s\", "
+        "\"note\": %s, \"partial\": %s}",
+        binary ? "true" : "false", count(edi, "sensor", NULL), ediGetFieldValue(rec, "value"),
+        ediGetFieldValue(rec, "active"), ediGetFieldValue(rec, "when"),
+        smatch(ediGetFieldValue(rec, "note"), NOTE) ? "true" : "false",
+        ediOpen(partial, "mdb", 0) ? "true" : "false");
+}
+
+
+/*
+    SQLite reader pool. Reads run on read-only connections in WAL mode and see committed writes.
+    Queries inside a transaction use the writer and see its uncommitted changes.
+ */
+static void pool()
+{
+#if ME_COM_SQLITE
+    Edi         *edi;
+    EdiCursor   *cursors[6];
+    EdiGrid     *grid;
+    cchar       *path;
+    bool        wal;
+    int         i, rows, updated, inside, after;
+
+    path = getDatabasePath("pool.sdb");
+    edi = ediOpen(path, "sdb", EDI_CREATE);
+    ediConfigure(edi, ediMakeJson("{ readers: 4, wal: true, synchronous: 'normal', cacheSize: '1MB' }"));
+    createSensors(edi);
+    wal = mprPathExists(sjoin(path, "-wal", NULL), R_OK);
+
+    //  More open cursors than readers
+    for (i = 0; i < 6; i++) {
+        cursors[i] = ediOpenCursor(edi, "sensor", "value >= 50");
+        ediNextRec(cursors[i]);
+    }
+    ediUpdateField(edi, "sensor", "1", "name", "updated");
+    updated = count(edi, "sensor", "name == updated");
+    for (rows = 1; ediNextRec(cursors[5]); rows++) ;
+    for (i = 0; i < 6; i++) {
+        ediCloseCursor(cursors[i]);
+    }
+
+    query(edi, "BEGIN TRANSACTION;", NULL);
+    query(edi, "DELETE FROM sensor WHERE name = 'odd';", NULL);
+    grid = query(edi, "SELECT * FROM sensor;", NULL);
+    inside = grid ? grid->nrecords : -1;
+    query(edi, "ROLLBACK;", NULL);
+    after = count(edi, "sensor", NULL);
+
+    render("{\"wal\": %s, \"rows\": %d, \"updated\": %d, \"inside\": %d, \"after\": %d}",
+        wal ? "true" : "false", rows, updated, inside, after);
+#else
+    render("{\"skip\": true}");
+#endif
+}
+
+
+/*
+    Join posts to users. The number of distinct users exceeds the batch size of the SQLite key lookup.
+ */
+static void join()
+{
+    Edi         *edi;
+    EdiGrid     *grid;
+    EdiRec      *rec;
+    cchar       *name, *path, *provider;
+    int         i, bad, user;
+
+    provider = param("provider");
+#if !ME_COM_SQLITE
+    if (smatch(provider, "sdb")) {
+        render("{\"skip\": true}");
+        return;
+    }
+#endif
+    path = getDatabasePath(sfmt("join.%s", provider));
+    if ((edi = ediOpen(path, provider, EDI_CREATE)) == 0) {
+        renderError(HTTP_CODE_BAD_REQUEST, "Cannot open database");
+        return;
+    }
+    ediAddTable(edi, "user");
+    ediAddColumn(edi, "user", "id", EDI_TYPE_INT, EDI_AUTO_INC | EDI_INDEX | EDI_KEY);
+    ediAddColumn(edi, "user", "name", EDI_TYPE_STRING, 0);
+    ediAddTable(edi, "post");
+    ediAddColumn(edi, "post", "id", EDI_TYPE_INT, EDI_AUTO_INC | EDI_INDEX | EDI_KEY);
+    ediAddColumn(edi, "post", "title", EDI_TYPE_STRING, 0);
+    ediAddColumn(edi, "post", "userId", EDI_TYPE_INT, 0);
+    for (i = 1; i <= 300; i++) {
+        rec = ediCreateRec(edi, "user");
+        ediSetField(rec, "name", sfmt("user-%d", i));
+        ediUpdateRec(edi, rec);
+    }
+    //  Some posts refer to users that do not exist
+    for (i = 0; i < 600; i++) {
+        rec = ediCreateRec(edi, "post");
+        ediSetField(rec, "title", sfmt("post-%d", i));
+        ediSetField(rec, "userId", itos(i % 310 + 1));
+        ediUpdateRec(edi, rec);
+    }
+    //  Only one user is supplied. The others are read in batches.
+    grid = ediJoin(edi, ediFindGrid(edi, "post", NULL), ediFindGrid(edi, "user", "id == 2"), NULL);
+    for (bad = 0, i = 0; i < grid->nrecords; i++) {
+        user = (int) (stoi(ediGetFieldValue(grid->records[i], "id")) - 1) % 310 + 1;
+        name = ediGetFieldValue(grid->records[i], "user.name");
+        if ((user <= 300) ? !smatch(name, sfmt("user-%d", user)) : name != 0) {
+            bad++;
+        }
+    }
+    render("{\"rows\": %d, \"bad\": %d}", grid->nrecords, bad);
+}
+
+
+ESP_EXPORT int esp_controller_esptest_edi(HttpRoute *route, MprModule *module) {
+    espAction(route, "edi/types", NULL, types);
+    espAction(route, "edi/columnar", NULL, columnar);
+    espAction(route, "edi/journal", NULL, journal);
+    espAction(route, "edi/snapshot", NULL, snapshot);
+    espAction(route, "edi/pool", NULL, pool);
+    espAction(route, "edi/join", NULL, join);
+    return 0;
+}
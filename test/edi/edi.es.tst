@@ -0,0 +1,79 @@
+/*
+    edi.tst - Test the MDB and SDB database providers
+ */
+
+const HTTP = tget('TM_HTTP') || "127.0.0.1:5100"
+let http: Http = new Http
+
+function run(action: String): Object {
+    http.get(HTTP + "/edi/" + action)
+    ttrue(http.status == 200)
+    let result = deserialize(http.response)
+    http.close()
+    return result
+}
+
+if (thas('ME_MDB')) {
+    //  Typed cells compare and sort numerically
+    let r = run("types")
+    ttrue(r.below == 10)
+    ttrue(r.first == "100")
+    ttrue(r.last == "2")
+    ttrue(r.signed == "-0.5")
+
+    //  Columnar table queries, aggregates and column type changes
+    r = run("columnar")
+    ttrue(r.found == 11)
+    ttrue(r.sum == 5100)
+    ttrue(r.min == 1.5)
+    ttrue(r.max == 100.5)
+    ttrue(r.avg == 51)
+    ttrue(r.odd == 50)
+    ttrue(r.before == 89)
+    ttrue(r.after == 9)
+    ttrue(r.na == "n/a")
+    ttrue(r.reloaded == 11)
+
+    //  Journaled row changes are replayed. An incomplete final record is ignored.
+    r = run("journal")
+    ttrue(r.journaled)
+    ttrue(r.rows == 99)
+    ttrue(r.name == "updated")
+    ttrue(r.removed)
+
+    //  Binary snapshot
+    r = run("snapshot")
+    ttrue(r.binary)
+    ttrue(r.rows == 101)
+    ttrue(r.value == "-0.25")
+    ttrue(r.active == "1")
+    ttrue(r.when == "1500000000000")
+    ttrue(r.note)
+    ttrue(!r.partial)
+
+    //  Join with foreign records read by key
+    r = run("join?provider=mdb")
+    ttrue(r.rows == 600)
+    ttrue(r.bad == 0)
+} else {
+    tskip("MDB not enabled")
+}
+
+if (thas('ME_SQLITE')) {
+    //  Reader pool
+    let r = run("pool")
+    ttrue(r.wal)
+    ttrue(r.rows == 51)
+    ttrue(r.updated == 1)
+    ttrue(r.inside == 51)
+    ttrue(r.after == 100)
+
+    //  Join with foreign records read in batches
+    r = run("join?provider=sdb")
+    ttrue(r.rows == 600)
+    ttrue(r.bad == 0)
+} else {
+    tskip("SQLite not enabled")
+}
+
+Path('db').removeAll()
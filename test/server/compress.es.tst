@@ -0,0 +1,67 @@
+/*
+    compress.tst - Dynamic response compression tests
+ */
+
+if (!thas('ME_ZLIB')) {
+    tskip("zlib not enabled")
+
+} else {
+    const HTTP = tget('TM_HTTP') || "127.0.0.1:5100"
+
+    function get(uri, headers = {}, method = 'GET'): Http {
+        let http: Http = new Http
+        http.setHeader('Accept-Encoding', 'gzip')
+        for (let [key, value] in headers) {
+            http.setHeader(key, value)
+        }
+        http.connect(method, HTTP + uri)
+        http.wait()
+        return http
+    }
+
+    //  Compressed response
+    let http = get('/compress/compress.esp')
+    ttrue(http.status == 200)
+    ttrue(http.header('Content-Encoding') == 'gzip')
+    ttrue(http.header('Vary').contains('Accept-Encoding'))
+    http.close()
+
+    //  Non-200 responses are not compressed
+    http = get('/compress/compress.esp?status=201')
+    ttrue(http.status == 201)
+    ttrue(!http.header('Content-Encoding'))
+    ttrue(http.response.contains('Line: 00799'))
+    http.close()
+
+    //  Range responses are not compressed
+    http = get('/compress/compress.esp', { Range: 'bytes=0-9' })
+    ttrue(http.status == 206)
+    ttrue(!http.header('Content-Encoding'))
+    ttrue(http.response == 'Line: 0000')
+    http.close()
+
+    //  HEAD requests are not compressed
+    http = get('/compress/compress.esp', {}, 'HEAD')
+    ttrue(http.status == 200)
+    ttrue(!http.header('Content-Encoding'))
+    http.close()
+
+    //  Content that is already encoded is not compressed again
+    http = get('/compress/compress.esp?encoding=identity')
+    ttrue(http.status == 200)
+    ttrue(http.header('Content-Encoding') == 'identity')
+    ttrue(http.response.contains('Line: 00799'))
+    http.close()
+
+    //  HTTP/1.0 responses are not compressed. Bypass http to send the request to the server.
+    let s = new Socket
+    s.connect(HTTP)
+    s.write("GET /compress/compress.esp HTTP/1.0\r\nAccept-Encoding: gzip\r\n\r\n")
+    let response = new ByteArray
+    let n
+    while ((n = s.read(response, -1)) != null) {}
+    let r = response.toString()
+    ttrue(r.indexOf('HTTP/1.0 200') == 0)
+    ttrue(!r.toLowerCase().contains('content-encoding'))
+    s.close()
+}
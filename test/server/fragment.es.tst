@@ -0,0 +1,39 @@
+/*
+    fragment.tst - Test the ESP view fragment cache
+ */
+
+const HTTP = tget('TM_HTTP') || "127.0.0.1:5100"
+let http: Http = new Http
+
+function render(run): Object {
+    http.get(HTTP + "/fragment.esp?run=" + run)
+    ttrue(http.status == 200)
+    let r = http.response
+    http.close()
+    return {
+        first: r.match(/First: \d+/)[0],
+        expire: r.match(/Expire: \d+/)[0],
+        empty: r.match(/Empty: \d+/)[0],
+    }
+}
+
+//  Miss then hit. The first fragment begins before any output is queued.
+let run = Date.now()
+let a = render(run)
+let b = render(run)
+ttrue(a.first == b.first)
+ttrue(a.expire == b.expire)
+
+//  An empty fragment is cached and its body is not run again
+ttrue(a.empty == b.empty)
+
+//  A different key is a miss
+let c = render(run + 1)
+ttrue(c.first != a.first)
+ttrue(c.empty != a.empty)
+
+//  The expire fragment has a one second lifespan
+App.sleep(2100)
+let d = render(run)
+ttrue(d.first == a.first)
+ttrue(d.expire != a.expire)
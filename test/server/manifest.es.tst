@@ -0,0 +1,65 @@
+/*
+    manifest.tst - ESP build manifest tests
+ */
+
+const HTTP = tget('TM_HTTP') || "127.0.0.1:5100"
+let http: Http = new Http
+
+/*
+    Find the manifest record for the test page
+ */
+function findRecord(): Object {
+    let manifest = Path('cache/manifest.json').readJSON()
+    for (let key in manifest) {
+        if (manifest[key].files['dist/manifest.esp']) {
+            return { module: Path('cache').join(key), record: manifest[key] }
+        }
+    }
+    return null
+}
+
+if (thas('ME_DEBUG')) {
+    let path = new Path("dist/manifest.esp")
+    let page = '<html><body><% render("First"); %></body></html>'
+
+    //  First build records the page content hash, size and the compiler command
+    path.write(page)
+    http.get(HTTP + "/manifest.esp")
+    ttrue(http.status == 200)
+    ttrue(http.response.contains("First"))
+    http.close()
+    let first = findRecord()
+    ttrue(first != null)
+    ttrue(first.module.exists)
+    ttrue(first.record.command)
+    ttrue(first.record.files['dist/manifest.esp'].hash)
+    ttrue(first.record.files['dist/manifest.esp'].size == path.size)
+    let built = first.module.modified.time
+
+    //  Touching the page without changing the content does not rebuild the module
+    App.sleep(1100)
+    path.write(page)
+    http.get(HTTP + "/manifest.esp")
+    ttrue(http.status == 200)
+    ttrue(http.response.contains("First"))
+    http.close()
+    let touched = findRecord()
+    ttrue(touched.record.files['dist/manifest.esp'].hash == first.record.files['dist/manifest.esp'].hash)
+    ttrue(touched.module.modified.time == built)
+
+    //  Changing the content rebuilds the module and updates the record
+    App.sleep(1100)
+    path.write('<html><body><% render("Second"); %></body></html>')
+    http.get(HTTP + "/manifest.esp")
+    ttrue(http.status == 200)
+    ttrue(http.response.contains("Second"))
+    http.close()
+    let changed = findRecord()
+    ttrue(changed.record.files['dist/manifest.esp'].hash != first.record.files['dist/manifest.esp'].hash)
+    ttrue(changed.module.modified.time != built)
+
+    path.remove()
+
+} else {
+    tskip("Run only in debug builds")
+}
@@ -0,0 +1,19 @@
+/*
+    safe.tst - Test that safe rendering is identical to mprEscapeHtml
+ */
+
+const HTTP = tget('TM_HTTP') || "127.0.0.1:5100"
+let http: Http = new Http
+
+http.get(HTTP + "/safe.esp")
+ttrue(http.status == 200)
+let lines = http.response.trim().split('\n')
+ttrue(lines.length == 8)
+for each (line in lines) {
+    let parts = line.split('|')
+    ttrue(parts.length == 3)
+    ttrue(parts[0] == parts[2])
+    ttrue(parts[1] == parts[2])
+}
+ttrue(lines[1] == '&lt;b&gt;bold&lt;/b&gt;|&lt;b&gt;bold&lt;/b&gt;|&lt;b&gt;bold&lt;/b&gt;')
+http.close()
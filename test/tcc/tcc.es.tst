@@ -0,0 +1,37 @@
+/*
+    tcc.tst - Test views compiled in-process with the embedded compiler
+ */
+
+if (!thas('ME_TCC')) {
+    tskip("Embedded compiler (tcc) not enabled")
+
+} else {
+    const HTTP = tget('TM_HTTP') || "127.0.0.1:7300"
+    let http: Http = new Http
+
+    //  Compiled and loaded in-process
+    http.get(HTTP + "/index.esp?name=tcc")
+    ttrue(http.status == 200)
+    ttrue(http.response.contains("Line 0"))
+    ttrue(http.response.contains("Line 2"))
+    ttrue(http.response.contains("Query: tcc"))
+    http.close()
+
+    if (thas('ME_DEBUG')) {
+        //  Modified views are recompiled in-process
+        let path = new Path("dist/reload.esp")
+        path.write('<html><body><% render("First"); %></body></html>')
+        http.get(HTTP + "/reload.esp")
+        ttrue(http.status == 200)
+        ttrue(http.response.contains("First"))
+        http.close()
+
+        App.sleep(1100)
+        path.write('<html><body><% render("Second"); %></body></html>')
+        http.get(HTTP + "/reload.esp")
+        ttrue(http.status == 200)
+        ttrue(http.response.contains("Second"))
+        http.close()
+        path.remove()
+    }
+}
@@ -0,0 +1,79 @@
+/*
+    deflate-limit.tst - Test a compressed message that decompresses beyond the message limit
+
+    The /deflate route limits messages to 64K. The message is 128K of zeros which compresses to 144 bytes.
+    The server must close the connection with status 1009 (message too big).
+ */
+
+const PORT = tget('TM_HTTP_PORT') || "4100"
+const ADDRESS = "127.0.0.1:" + PORT
+
+/*
+    128K zeros compressed with raw deflate. The trailing 0x00 0x00 0xFF 0xFF is removed.
+ */
+const PREFIX = [ 0xEC, 0xC1, 0x31, 0x01, 0x00, 0x00, 0x00, 0xC2, 0xA0, 0xF5, 0x4F, 0xED, 0x61, 0x0D, 0xA0 ]
+const ZEROS = 127
+const SUFFIX = [ 0x6E, 0x00 ]
+
+/*
+    Return the offset of the first byte after the response headers or -1 if not yet received
+ */
+function headerEnd(data: ByteArray): Number {
+    for (let i = 0; i + 3 < data.writePosition; i++) {
+        if (data[i] == 13 && data[i + 1] == 10 && data[i + 2] == 13 && data[i + 3] == 10) {
+            return i + 4
+        }
+    }
+    return -1
+}
+
+if (!thas('ME_ZLIB')) {
+    tskip("zlib not enabled")
+
+} else {
+    let s = new Socket
+    s.connect(ADDRESS)
+    s.write("GET /deflate/basic/len HTTP/1.1\r\n" +
+        "Host: " + ADDRESS + "\r\n" +
+        "Upgrade: websocket\r\n" +
+        "Connection: Upgrade\r\n" +
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n" +
+        "Sec-WebSocket-Version: 13\r\n" +
+        "Sec-WebSocket-Protocol: chat\r\n" +
+        "Sec-WebSocket-Extensions: permessage-deflate\r\n\r\n")
+
+    let data = new ByteArray
+    while (headerEnd(data) < 0 && s.read(data, -1) != null) {}
+    let end = headerEnd(data)
+    ttrue(end > 0)
+    ttrue(data.toString().slice(0, end).contains("Sec-WebSocket-Extensions: permessage-deflate"))
+
+    /*
+        Single compressed text frame (FIN, RSV1) with a 16-bit length and a zero mask key
+     */
+    let length = PREFIX.length + ZEROS + SUFFIX.length
+    let msg = new ByteArray
+    msg.writeByte(0xC1, 0x80 | 126, length >> 8, length & 0xFF, 0, 0, 0, 0)
+    for each (b in PREFIX) {
+        msg.writeByte(b)
+    }
+    for (let i = 0; i < ZEROS; i++) {
+        msg.writeByte(0)
+    }
+    for each (b in SUFFIX) {
+        msg.writeByte(b)
+    }
+    s.write(msg)
+
+    /*
+        Expect a close frame with status 1009
+     */
+    while ((data.writePosition - end) < 4) {
+        if (s.read(data, -1) == null) {
+            break
+        }
+    }
+    ttrue(data[end] == 0x88)
+    ttrue(((data[end + 2] << 8) | data[end + 3]) == 1009)
+    s.close()
+}
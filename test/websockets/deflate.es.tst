@@ -0,0 +1,87 @@
+/*
+    deflate.tst - Test a permessage-deflate compressed message sent in multiple frames
+
+    The WebSocket class does not offer permessage-deflate, so the handshake and frames are written to a socket.
+ */
+
+const PORT = tget('TM_HTTP_PORT') || "4100"
+const ADDRESS = "127.0.0.1:" + PORT
+
+/*
+    "0123456789" repeated 100 times compressed with raw deflate. The trailing 0x00 0x00 0xFF 0xFF is removed.
+ */
+const COMPRESSED = [ 50, 48, 52, 50, 54, 49, 53, 51, 183, 176, 52, 24, 101, 141, 178, 70, 89, 195, 148, 5, 0 ]
+
+/*
+    Create a masked client frame. The mask key is zero so the payload is unchanged.
+ */
+function frame(code: Number, payload: Array): ByteArray {
+    let buf = new ByteArray
+    buf.writeByte(code)
+    buf.writeByte(0x80 | payload.length)
+    buf.writeByte(0, 0, 0, 0)
+    for each (b in payload) {
+        buf.writeByte(b)
+    }
+    return buf
+}
+
+/*
+    Return the offset of the first byte after the response headers or -1 if not yet received
+ */
+function headerEnd(data: ByteArray): Number {
+    for (let i = 0; i + 3 < data.writePosition; i++) {
+        if (data[i] == 13 && data[i + 1] == 10 && data[i + 2] == 13 && data[i + 3] == 10) {
+            return i + 4
+        }
+    }
+    return -1
+}
+
+if (!thas('ME_ZLIB')) {
+    tskip("zlib not enabled")
+
+} else {
+    let s = new Socket
+    s.connect(ADDRESS)
+    s.write("GET /deflate/basic/len HTTP/1.1\r\n" +
+        "Host: " + ADDRESS + "\r\n" +
+        "Upgrade: websocket\r\n" +
+        "Connection: Upgrade\r\n" +
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n" +
+        "Sec-WebSocket-Version: 13\r\n" +
+        "Sec-WebSocket-Protocol: chat\r\n" +
+        "Sec-WebSocket-Extensions: permessage-deflate\r\n\r\n")
+
+    let data = new ByteArray
+    while (headerEnd(data) < 0 && s.read(data, -1) != null) {}
+    let end = headerEnd(data)
+    ttrue(end > 0)
+    let headers = data.toString().slice(0, end)
+    ttrue(headers.contains("101 Switching Protocols"))
+    ttrue(headers.contains("Sec-WebSocket-Extensions: permessage-deflate"))
+
+    /*
+        Send the message in two frames. RSV1 is set on the first frame only.
+     */
+    let half = Math.floor(COMPRESSED.length / 2)
+    s.write(frame(0x41, COMPRESSED.slice(0, half)))
+    s.write(frame(0x80, COMPRESSED.slice(half)))
+
+    /*
+        The "len" action replies with the decompressed message length. Short replies are not compressed.
+     */
+    while ((data.writePosition - end) < 2 || (data.writePosition - end - 2) < (data[end + 1] & 0x7f)) {
+        if (s.read(data, -1) == null) {
+            break
+        }
+    }
+    ttrue(data[end] == 0x81)
+    data.readPosition = end + 2
+    let reply = data.readString(data[end + 1] & 0x7f)
+    ttrue(reply.contains("length: 1000"))
+    ttrue(reply.contains('data: "0123456789"'))
+
+    s.write(frame(0x88, [ 0x03, 0xE8 ]))
+    s.close()
+}